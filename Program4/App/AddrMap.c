@@ -0,0 +1,65 @@
+/*--------------- A d d r M a p . c ---------------
+
+by: Michael Nickelson
+
+PURPOSE
+Set of local node addresses, kept as a 256 bit map. Bit (addr & 31) of
+word (addr >> 5) is set when addr is one of ours. Addresses can be added
+and removed at run time, for example to join a group address.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+*/
+
+#include "includes.h"
+#include "AddrMap.h"
+#include "Payload.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define AddrBits 32
+#define AddrShift 5
+#define AddrWords (256 / AddrBits)
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+static volatile CPU_INT32U addrMap[AddrWords];
+
+/*--------------- A d d r M a p I n i t ---------------
+Start with MyAddress as the only local address
+*/
+void AddrMapInit(void){
+  CPU_INT08U i;
+  
+  for(i = 0; i < AddrWords; i++)
+    addrMap[i] = 0;
+  AddrMapAdd(MyAddress);
+}
+
+/*--------------- A d d r M a p A d d ---------------
+Accept packets for addr
+*/
+void AddrMapAdd(CPU_INT08U addr){
+  CPU_SR_ALLOC();
+  
+  // Keep the read-modify-write whole if another task changes the map
+  CPU_CRITICAL_ENTER();
+  addrMap[addr >> AddrShift] |= (CPU_INT32U) 1 << (addr & (AddrBits - 1));
+  CPU_CRITICAL_EXIT();
+}
+
+/*--------------- A d d r M a p R e m o v e ---------------
+Stop accepting packets for addr
+*/
+void AddrMapRemove(CPU_INT08U addr){
+  CPU_SR_ALLOC();
+  
+  CPU_CRITICAL_ENTER();
+  addrMap[addr >> AddrShift] &= ~((CPU_INT32U) 1 << (addr & (AddrBits - 1)));
+  CPU_CRITICAL_EXIT();
+}
+
+/*--------------- A d d r M a p H a s ---------------
+Return true if addr is one of ours, otherwise false
+*/
+CPU_BOOLEAN AddrMapHas(CPU_INT08U addr){
+  return (addrMap[addr >> AddrShift] >> (addr & (AddrBits - 1))) & 1;
+}
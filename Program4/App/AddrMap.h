@@ -0,0 +1,25 @@
+/*--------------- A d d r M a p . h ---------------
+
+by: Michael Nickelson
+
+PURPOSE - Header file
+Set of local node addresses, kept as a 256 bit map so that checking a
+destination address takes one word lookup. Used by the parser's
+destination filter and by the payload task.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+*/
+
+#ifndef ADDRMAP_H
+#define ADDRMAP_H
+
+#include "includes.h"
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void AddrMapInit(void);
+void AddrMapAdd(CPU_INT08U addr);
+void AddrMapRemove(CPU_INT08U addr);
+CPU_BOOLEAN AddrMapHas(CPU_INT08U addr);
+
+#endif
@@ -7,6 +7,10 @@ Buffer pair functions and definitions
 
 CHANGES
 02/19/2014 mn - Initial submission
+10/19/2026 mn - Added block and span access
+10/19/2026 mn - Added PutBfrEmpty
+10/19/2026 mn - Added free space, mark and rollback for packing records
+10/19/2026 mn - Added in place writes to the put buffer
 */
 
 #include "BfrPair.h"
@@ -54,6 +58,67 @@ CPU_BOOLEAN PutBfrClosed(BfrPair *bfrPair){
   return bfrPair->buffers[bfrPair->putBrfNum].closed;
 }
 
+/*--------------- P u t B f r E m p t y -----------------
+Return true if nothing has been added to the put buffer, otherwise false
+*/
+CPU_BOOLEAN PutBfrEmpty(BfrPair *bfrPair){
+  return BfrEmpty(&bfrPair->buffers[bfrPair->putBrfNum]);
+}
+
+/*--------------- P u t B f r F r e e -----------------
+Return how many more bytes the put buffer can take
+*/
+CPU_INT16U PutBfrFree(BfrPair *bfrPair){
+  Buffer *bfr = &bfrPair->buffers[bfrPair->putBrfNum];
+  
+  return bfr->closed ? 0 : bfr->size - bfr->putIndex;
+}
+
+/*--------------- P u t B f r S p a c e -----------------
+Return the address of the next free byte in the put buffer. Up to
+PutBfrFree bytes may be written there and then added with PutBfrCommit.
+*/
+CPU_INT08U *PutBfrSpace(BfrPair *bfrPair){
+  Buffer *bfr = &bfrPair->buffers[bfrPair->putBrfNum];
+  
+  return &bfr->buffer[bfr->putIndex];
+}
+
+/*--------------- P u t B f r C o m m i t -----------------
+Add n bytes already written at PutBfrSpace to the put buffer. Close the
+buffer if it becomes full.
+*/
+void PutBfrCommit(BfrPair *bfrPair, CPU_INT16U n){
+  Buffer *bfr = &bfrPair->buffers[bfrPair->putBrfNum];
+  
+  bfr->putIndex += n;
+  if(bfr->putIndex >= bfr->size)
+    BfrClose(bfr);
+  
+  return;
+}
+
+/*--------------- P u t B f r M a r k -----------------
+Return the position of the next byte added to the put buffer, for use with
+PutBfrRollback
+*/
+CPU_INT16U PutBfrMark(BfrPair *bfrPair){
+  return bfrPair->buffers[bfrPair->putBrfNum].putIndex;
+}
+
+/*--------------- P u t B f r R o l l b a c k -----------------
+Drop everything added to the put buffer since mark was taken. The bytes
+before mark are kept, and the buffer is reopened if filling it closed it.
+*/
+void PutBfrRollback(BfrPair *bfrPair, CPU_INT16U mark){
+  Buffer *bfr = &bfrPair->buffers[bfrPair->putBrfNum];
+  
+  bfr->putIndex = mark;
+  BfrOpen(bfr);
+  
+  return;
+}
+
 /*--------------- G e t B f r C l o s e d -----------------
 Return true if the get buffer is closed, otherwise false
 */
@@ -102,6 +167,31 @@ CPU_INT16S GetBfrRemByte(BfrPair *bfrPair){
     return BfrRemoveByte(&bfrPair->buffers[!(bfrPair->putBrfNum)]);
 }
 
+/*--------------- P u t B f r A d d B l o c k -----------------
+Add up to n bytes to the put buffer in one copy. Returns the number added.
+*/
+CPU_INT16U PutBfrAddBlock(BfrPair *bfrPair, const CPU_INT08U *block,
+                          CPU_INT16U n){
+  return BfrAddBlock(&bfrPair->buffers[bfrPair->putBrfNum], block, n);
+}
+
+/*--------------- G e t B f r S p a n -----------------
+Point span at the unread bytes of the get buffer and return how many there
+are.
+*/
+CPU_INT16U GetBfrSpan(BfrPair *bfrPair, CPU_INT08U **span){
+  return BfrSpan(&bfrPair->buffers[!(bfrPair->putBrfNum)], span);
+}
+
+/*--------------- G e t B f r S k i p -----------------
+Remove n unread bytes from the get buffer
+*/
+void GetBfrSkip(BfrPair *bfrPair, CPU_INT16U n){
+  BfrSkip(&bfrPair->buffers[!(bfrPair->putBrfNum)], n);
+  
+  return;
+}
+
 /*--------------- B f r P a i r S w a p p a b l e -----------------
 Return true if the buffer pair is swappable, otherise false
 */
@@ -8,6 +8,10 @@ Header file
 
 CHANGES
 02/19/2014 mn - Initial submission
+10/19/2026 mn - Added block and span access
+10/19/2026 mn - Added PutBfrEmpty
+10/19/2026 mn - Added free space, mark and rollback for packing records
+10/19/2026 mn - Added in place writes to the put buffer
 */
 
 #ifndef BFRPAIR_H
@@ -42,8 +46,23 @@ CPU_INT16S PutBfrAddByte(BfrPair *bfrPair,
                          CPU_INT16S byte);
 CPU_INT16S GetBfrNextByte(BfrPair *bfrPair);
 CPU_INT16S GetBfrRemByte(BfrPair *bfrPair);
+CPU_INT16U PutBfrAddBlock(BfrPair *bfrPair,
+                          const CPU_INT08U *block,
+                          CPU_INT16U n);
+CPU_INT16U GetBfrSpan(BfrPair *bfrPair,
+                      CPU_INT08U **span);
+void GetBfrSkip(BfrPair *bfrPair,
+                CPU_INT16U n);
 CPU_BOOLEAN BfrPairSwappable(BfrPair *bfrPair);
 CPU_BOOLEAN PutBfrClosed(BfrPair *bfrPair);
+CPU_BOOLEAN PutBfrEmpty(BfrPair *bfrPair);
+CPU_INT16U PutBfrFree(BfrPair *bfrPair);
+CPU_INT08U *PutBfrSpace(BfrPair *bfrPair);
+void PutBfrCommit(BfrPair *bfrPair,
+                  CPU_INT16U n);
+CPU_INT16U PutBfrMark(BfrPair *bfrPair);
+void PutBfrRollback(BfrPair *bfrPair,
+                    CPU_INT16U mark);
 CPU_BOOLEAN GetBfrClosed(BfrPair *bfrPair);
 
 #endif
\ No newline at end of file
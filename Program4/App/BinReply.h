@@ -0,0 +1,54 @@
+/*--------------- B i n R e p l y . h ---------------
+
+by: Michael Nickelson
+
+PURPOSE - Header file
+Layout of the binary replies, shared by the payload task and the host
+reply decoder. It holds only constants, so ReplyDecode reads replies from
+the same definitions the firmware writes them with.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Time stamp taken from the Clock
+*/
+
+#ifndef BINREPLY_H
+#define BINREPLY_H
+
+#include "FrameChk.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+/* A binary reply is framed as FrameChk lays packets out, with the same
+   preamble, length byte and checksum or CRC. Its body is
+     destination  BinHost
+     source       node the reading came from, 0 if not known
+     type         message type, with BinStamped set if a time stamp follows
+     time stamp   receive time in microseconds since start up, only if
+                  BinStamped is set. The low 32 bits of the Clock, so it
+                  wraps every 71.6 minutes.
+     data         the reading, decoded
+   Multibyte values are little endian. */
+#define BinHost 0
+#define BinStamped 0x80
+#define BinTypeMask 0x7F
+#define BinStampLength 4
+
+/* Types that are not sensor readings */
+#define BinText 0x7E            /* Reply text, without a terminator */
+#define BinError 0x7F           /* Error_t, or an Assert_t for info */
+
+/* Data of each reading */
+#define BinTempLength 1         /* Temperature, signed */
+#define BinPresLength 2         /* Pressure */
+#define BinHumLength 2          /* Dew point, signed, then humidity */
+#define BinWindLength 4         /* Speed in tenths, then direction */
+#define BinRadLength 2          /* Solar radiation intensity */
+#define BinTimeLength 6         /* Year, then month, day, hour, minute */
+#define BinPrecipLength 2       /* Depth in hundredths */
+#define BinErrorLength 1
+
+/* Framing added to the data of a reply */
+#define BinOverhead (HeaderLength + MinBodyLength + BinStampLength + \
+                     TrailerLength)
+
+#endif
@@ -7,8 +7,10 @@ Buffer functions and definitions
 
 CHANGES
 02/19/2014 mn - Initial submission
+10/19/2026 mn - Added block and span access
 */
 
+#include <string.h>
 #include "Buffer.h"
 
 /*--------------- B f r I n i t -----------------
@@ -112,4 +114,45 @@ CPU_INT16S BfrRemoveByte(Buffer *bfr){
     bfr->closed = FALSE;
   
   return retVal;
+}
+
+/*--------------- B f r A d d B l o c k -----------------
+Add up to n bytes to the given buffer in one copy and return the number
+added. Close the buffer if it becomes full.
+*/
+CPU_INT16U BfrAddBlock(Buffer *bfr, const CPU_INT08U *block, CPU_INT16U n){
+  if(BfrClosed(bfr))
+    return 0;
+  
+  if(n > bfr->size - bfr->putIndex)
+    n = bfr->size - bfr->putIndex;
+  memcpy(&bfr->buffer[bfr->putIndex], block, n);
+  bfr->putIndex += n;
+  
+  if(bfr->putIndex >= bfr->size)
+    BfrClose(bfr);
+  
+  return n;
+}
+
+/*--------------- B f r S p a n -----------------
+Point span at the unread bytes of the buffer and return how many there are.
+The bytes stay in the buffer until BfrSkip removes them.
+*/
+CPU_INT16U BfrSpan(Buffer *bfr, CPU_INT08U **span){
+  *span = &bfr->buffer[bfr->getIndex];
+  
+  return BfrEmpty(bfr) ? 0 : bfr->putIndex - bfr->getIndex;
+}
+
+/*--------------- B f r S k i p -----------------
+Remove n unread bytes from the buffer. Open the buffer if it becomes empty.
+*/
+void BfrSkip(Buffer *bfr, CPU_INT16U n){
+  bfr->getIndex += n;
+  
+  if(BfrEmpty(bfr))
+    bfr->closed = FALSE;
+  
+  return;
 }
\ No newline at end of file
@@ -8,6 +8,7 @@ Header file
 
 CHANGES
 02/19/2014 mn - Initial submission
+10/19/2026 mn - Added block and span access
 */
 
 #ifndef BUFFER_H
@@ -37,6 +38,13 @@ CPU_INT16S BfrAddByte(Buffer *bfr,
                       CPU_INT16S theByte);
 CPU_INT16S BfrNextByte(Buffer *bfr);
 CPU_INT16S BfrRemoveByte(Buffer *bfr);
+CPU_INT16U BfrAddBlock(Buffer *bfr,
+                       const CPU_INT08U *block,
+                       CPU_INT16U n);
+CPU_INT16U BfrSpan(Buffer *bfr,
+                   CPU_INT08U **span);
+void BfrSkip(Buffer *bfr,
+             CPU_INT16U n);
 CPU_BOOLEAN BfrClosed(Buffer *bfr);
 CPU_BOOLEAN BfrEmpty(Buffer *bfr);
 
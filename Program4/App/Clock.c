@@ -0,0 +1,72 @@
+/*--------------- C l o c k . c ---------------
+
+by: Michael Nickelson
+
+PURPOSE
+64 bit microsecond clock built on the CPU_TS timer. Each read of the
+clock reads the timer and counts a wrap if it has gone back since the
+last read, so reads must come at least every ClockUpdateSecs. A time
+stamp taken before the read is placed on the clock by how long ago it
+was taken, which is right as long as that is less than one wrap.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+*/
+
+#include "includes.h"
+#include "Clock.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define TsBits 32               /* Bits in a CPU_TS */
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+static CPU_INT32U wraps;        // Of the timer since start up
+static CPU_TS lastTs;           // Timer at the last read
+
+/*----- l o c a l   f u n c t i o n    p r o t o t y p e s -----*/
+static CPU_INT64U ClockTicks(CPU_TS ts);
+
+/*--------------- C l o c k U p d a t e ---------------
+Read the clock to keep its count of wraps. Called at least every
+ClockUpdateSecs when the clock is not otherwise read.
+*/
+void ClockUpdate(void){
+  ClockTicks(CPU_TS_Get32());
+}
+
+/*--------------- C l o c k N o w U s ---------------
+Return the microseconds since start up
+*/
+CPU_INT64U ClockNowUs(void){
+  return ClockUs(CPU_TS_Get32());
+}
+
+/*--------------- C l o c k U s ---------------
+Return the time of a CPU_TS time stamp taken within the last wrap, in
+microseconds since start up
+*/
+CPU_INT64U ClockUs(CPU_TS ts){
+  CPU_ERR cpuErr;
+  
+  return ClockTicks(ts) / (CPU_TS_TmrFreqGet(&cpuErr) / UsPerSec);
+}
+
+/*--------------- C l o c k T i c k s ---------------
+Read the timer, counting a wrap if it has gone back, and return the
+timer ticks since start up at time stamp ts
+*/
+static CPU_INT64U ClockTicks(CPU_TS ts){
+  CPU_TS now;
+  CPU_INT32U w;
+  CPU_SR_ALLOC();
+  
+  CPU_CRITICAL_ENTER();
+  now = CPU_TS_Get32();
+  if(now < lastTs)
+    wraps++;
+  lastTs = now;
+  w = wraps;
+  CPU_CRITICAL_EXIT();
+  
+  return ((CPU_INT64U) w << TsBits | now) - (CPU_TS) (now - ts);
+}
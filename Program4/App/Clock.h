@@ -0,0 +1,37 @@
+/*--------------- C l o c k . h ---------------
+
+by: Michael Nickelson
+
+PURPOSE - Header file
+Microseconds since start up, kept in 64 bits so reply time stamps and
+reading ages do not wrap with the 32 bit CPU_TS timer, every 59.6 s at
+72 MHz. CPU_TS time stamps taken within the last wrap are converted to
+the same clock.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Time unit constants shared by the modules that convert
+                 times
+*/
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include "includes.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define UsPerSec 1000000
+#define UsPerMs 1000
+
+/* Longest time between calls to the clock, in seconds. It only counts the
+   wraps it sees, so it must be read at least once per wrap of CPU_TS. */
+#ifndef ClockUpdateSecs
+#define ClockUpdateSecs 20
+#endif
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void ClockUpdate(void);
+CPU_INT64U ClockNowUs(void);
+CPU_INT64U ClockUs(CPU_TS ts);
+
+#endif
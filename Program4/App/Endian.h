@@ -0,0 +1,127 @@
+/*--------------- E n d i a n . h ---------------
+
+by: Michael Nickelson
+
+PURPOSE - Header file
+Loads and stores of 16 and 32 bit fields at any alignment, in either byte
+order. Packet fields are big endian and binary replies little endian, and
+both sit at odd offsets in packed records.
+Each accessor is one unaligned load or store and, when the byte order
+differs from the CPU's, one byte swap: LDR/LDRH and REV/REV16 on
+Cortex-M3, MOV and BSWAP (or MOVBE) on x86. Cortex-M3 allows unaligned
+LDR and LDRH unless UNALIGN_TRP is set, which this project leaves clear.
+The accessors are static inline over compiler builtins, so the host tools
+include this header as it is.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+*/
+
+#ifndef ENDIAN_H
+#define ENDIAN_H
+
+#include "includes.h"
+#include "string.h"
+
+#if defined(__ICCARM__)
+#include <intrinsics.h>
+#endif
+
+/* The CPU stores little endian: Cortex-M3 as configured on the STM32, and
+   x86 */
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "Endian.h assumes a little endian CPU"
+#endif
+
+/*----- b y t e   s w a p s -----*/
+#if defined(__ICCARM__)
+#define EndianSwap16(v) ((CPU_INT16U) __REV16(v))
+#define EndianSwap32(v) ((CPU_INT32U) __REV(v))
+#elif defined(__GNUC__)
+#define EndianSwap16(v) __builtin_bswap16(v)
+#define EndianSwap32(v) __builtin_bswap32(v)
+#else
+#define EndianSwap16(v) ((CPU_INT16U) ((v) << 8 | (v) >> 8))
+#define EndianSwap32(v) ((v) << 24 | ((v) << 8 & 0xFF0000) | \
+                         ((v) >> 8 & 0xFF00) | (v) >> 24)
+#endif
+
+/*----- u n a l i g n e d   l o a d s   a n d   s t o r e s -----*/
+/* IAR takes a __packed pointer as leave to use a plain unaligned LDR.
+   Elsewhere memcpy of a fixed size becomes a single load or store. */
+#if defined(__ICCARM__)
+static inline CPU_INT16U EndianLoad16(const void *p){
+  return *(const __packed CPU_INT16U *) p;
+}
+
+static inline CPU_INT32U EndianLoad32(const void *p){
+  return *(const __packed CPU_INT32U *) p;
+}
+
+static inline void EndianStore16(void *p, CPU_INT16U v){
+  *(__packed CPU_INT16U *) p = v;
+}
+
+static inline void EndianStore32(void *p, CPU_INT32U v){
+  *(__packed CPU_INT32U *) p = v;
+}
+#else
+static inline CPU_INT16U EndianLoad16(const void *p){
+  CPU_INT16U v;
+
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline CPU_INT32U EndianLoad32(const void *p){
+  CPU_INT32U v;
+
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline void EndianStore16(void *p, CPU_INT16U v){
+  memcpy(p, &v, sizeof(v));
+}
+
+static inline void EndianStore32(void *p, CPU_INT32U v){
+  memcpy(p, &v, sizeof(v));
+}
+#endif
+
+/*----- f i e l d   a c c e s s o r s -----*/
+/* Big endian, as packet fields are sent */
+static inline CPU_INT16U EndianGet16BE(const void *p){
+  return EndianSwap16(EndianLoad16(p));
+}
+
+static inline CPU_INT32U EndianGet32BE(const void *p){
+  return EndianSwap32(EndianLoad32(p));
+}
+
+/* Little endian, as binary reply fields are sent */
+static inline CPU_INT16U EndianGet16LE(const void *p){
+  return EndianLoad16(p);
+}
+
+static inline CPU_INT32U EndianGet32LE(const void *p){
+  return EndianLoad32(p);
+}
+
+static inline void EndianPut16BE(void *p, CPU_INT16U v){
+  EndianStore16(p, EndianSwap16(v));
+}
+
+static inline void EndianPut32BE(void *p, CPU_INT32U v){
+  EndianStore32(p, EndianSwap32(v));
+}
+
+static inline void EndianPut16LE(void *p, CPU_INT16U v){
+  EndianStore16(p, v);
+}
+
+static inline void EndianPut32LE(void *p, CPU_INT32U v){
+  EndianStore32(p, v);
+}
+
+#endif
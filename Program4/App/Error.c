@@ -7,52 +7,45 @@ Generate error and assert messages
 
 CHANGES
 02/19/2014 mn - Initial submission
+10/19/2026 mn - Messages are const tables with compile time lengths
+10/19/2026 mn - Dropped the Payload.h include, nothing here uses it
 */
 
 #include "includes.h"
 #include "Error.h"
-#include "Payload.h"
 
-/*--------------- D i s p E r r o r ---------------
-Generate an error message sent to reply array and sent to reply buffer by
-payload task.
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+/* Table entry for a string literal, its length worked out by the compiler */
+#define MsgEntry(s) {s, sizeof(s) - 1}
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+/* Error messages by -Error_t. Entry 0 stands in for anything unknown. */
+static const Msg_t ErrMsgs[NumErrors] = {
+  MsgEntry("\a*** ERROR: Unkown Message Type\n"),
+  MsgEntry("\a*** ERROR: Bad Preamble Byte 1\n"),
+  MsgEntry("\a*** ERROR: Bad Preamble Byte 2\n"),
+  MsgEntry("\a*** ERROR: Bad Preamble Byte 3\n"),
+  MsgEntry("\a*** ERROR: Checksum error\n"),
+  MsgEntry("\a*** ERROR: Bad Packet Size\n"),
+  MsgEntry("\a*** ERROR: Unkown Message Type\n")
+};
+
+/* Assert messages by Assert_t, then one for anything unknown */
+static const Msg_t AssertMsgs[NumAsserts + 1] = {
+  MsgEntry("\a*** Info: Not My Address\n"),
+  MsgEntry("\a*** Unknown Assertion\n")
+};
+
+/*--------------- E r r M s g ---------------
+Return the message for error e. The payload task sends it as it is.
 */
-void DispErr(Error_t e, CPU_CHAR reply[]){
-  
-  switch(e){
-    case(ERR_PREAMBLE_1):
-      sprintf(reply, "\a*** ERROR: Bad Preamble Byte 1\n");
-      break;
-    case(ERR_PREAMBLE_2):
-      sprintf(reply, "\a*** ERROR: Bad Preamble Byte 2\n");
-      break;
-    case(ERR_PREAMBLE_3):
-      sprintf(reply, "\a*** ERROR: Bad Preamble Byte 3\n");
-      break;
-    case(ERR_CHECKSUM):
-      sprintf(reply, "\a*** ERROR: Checksum error\n");
-      break;
-    case(ERR_LEN):
-      sprintf(reply, "\a*** ERROR: Bad Packet Size\n");
-      break;
-    default:
-      sprintf(reply, "\a*** ERROR: Unkown Message Type\n");
-      break;
-  }
+const Msg_t *ErrMsg(Error_t e){
+  return (e < 0 && e > -NumErrors) ? &ErrMsgs[-e] : &ErrMsgs[0];
 }
 
-/*--------------- D i s p A s s e r t ---------------
-Generate an assert message sent to reply array and sent to reply buffer by
-payload task.
+/*--------------- A s s e r t M s g ---------------
+Return the message for assert a. The payload task sends it as it is.
 */
-void DispAssert(Assert_t a, CPU_CHAR reply[]){
-
-  switch(a){
-    case(ASS_ADDRESS):
-      sprintf(reply, "\a*** Info: Not My Address\n");
-      break;
-    default:
-      sprintf(reply, "\a*** Unknown Assertion\n");
-      break;
-  }
-}
\ No newline at end of file
+const Msg_t *AssertMsg(Assert_t a){
+  return (a >= 0 && a < NumAsserts) ? &AssertMsgs[a] : &AssertMsgs[NumAsserts];
+}
@@ -9,6 +9,8 @@ Header file
 CHANGES
 02-19-14 mn -  Initial submission
 03-12-14 mn -  Remove preamble error prototype as the function is no longer used
+10-19-26 mn -  Added NumErrors
+10-19-26 mn -  Messages come from const tables with their lengths
 */
 
 #ifndef Errors_H
@@ -22,10 +24,19 @@ typedef enum {ERR_PREAMBLE_1 = -1,
               ERR_LEN = -5,
               ERR_MSG_TYPE = -6} Error_t;
 
-typedef enum {ASS_ADDRESS} Assert_t;
+#define NumErrors 7             /* Error counts are indexed by -Error_t */
+
+typedef enum {ASS_ADDRESS,
+              NumAsserts} Assert_t;
+
+/* A constant message and its length, without the terminator */
+typedef struct {
+  const CPU_CHAR *text;
+  CPU_INT08U len;
+} Msg_t;
 
 /*----- f u n c t i o n    p r o t o t y p e s -----*/
-void DispErr(Error_t e, CPU_CHAR reply[]);
-void DispAssert(Assert_t a, CPU_CHAR reply[]);
+const Msg_t *ErrMsg(Error_t e);
+const Msg_t *AssertMsg(Assert_t a);
 
 #endif
\ No newline at end of file
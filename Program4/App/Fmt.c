@@ -0,0 +1,145 @@
+/*--------------- F m t . c ---------------
+
+by: Michael Nickelson
+
+PURPOSE
+Small text formatter for replies, used in place of sprintf. There are no
+format strings to interpret and no variable argument lists, so each call
+does only the work its field needs and uses a few words of stack.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Added FmtFixed
+10-19-2026 mn -  Added FmtUDec64
+10-19-2026 mn -  BCD nibbles from MsgDefs.h
+*/
+
+#include "Fmt.h"
+#include "MsgDefs.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define MaxUDecDigits 10        /* 4294967295 */
+#define Giga 1000000000UL       /* 64 bit values are written 9 digits apart */
+
+/*--------------- F m t S t r ---------------
+Append string s
+*/
+CPU_CHAR *FmtStr(CPU_CHAR *p, const CPU_CHAR *s){
+  while(*s)
+    *p++ = *s++;
+  *p = '\0';
+  
+  return p;
+}
+
+/*--------------- F m t C h a r s ---------------
+Append at most n characters of s, stopping early at a terminator
+*/
+CPU_CHAR *FmtChars(CPU_CHAR *p, const CPU_CHAR *s, CPU_INT16U n){
+  while(n-- && *s)
+    *p++ = *s++;
+  *p = '\0';
+  
+  return p;
+}
+
+/*--------------- F m t U D e c ---------------
+Append v in decimal
+*/
+CPU_CHAR *FmtUDec(CPU_CHAR *p, CPU_INT32U v){
+  CPU_CHAR digits[MaxUDecDigits];
+  CPU_INT08U n = 0;
+  
+  // Digits come out least significant first
+  do{
+    digits[n++] = '0' + v % 10;
+    v /= 10;
+  }while(v);
+  while(n)
+    *p++ = digits[--n];
+  *p = '\0';
+  
+  return p;
+}
+
+/*--------------- F m t U D e c 6 4 ---------------
+Append a 64 bit v in decimal. The value is split at 10^9 so the digits
+come from 32 bit divides, with one 64 bit divide for each split.
+*/
+CPU_CHAR *FmtUDec64(CPU_CHAR *p, CPU_INT64U v){
+  CPU_INT32U low;
+  CPU_INT32U scale;
+  
+  if(v <= 0xFFFFFFFF)
+    return FmtUDec(p, (CPU_INT32U) v);
+  
+  low = v % Giga;
+  p = FmtUDec64(p, v / Giga);
+  // Pad the low part out to 9 digits
+  for(scale = Giga / 10; scale > 1 && low < scale; scale /= 10)
+    *p++ = '0';
+  
+  return FmtUDec(p, low);
+}
+
+/*--------------- F m t S D e c ---------------
+Append v in decimal, with a minus sign if it is negative
+*/
+CPU_CHAR *FmtSDec(CPU_CHAR *p, CPU_INT32S v){
+  if(v < 0){
+    *p++ = '-';
+    // Negate as unsigned so the most negative value works too
+    return FmtUDec(p, 0 - (CPU_INT32U) v);
+  }
+  
+  return FmtUDec(p, v);
+}
+
+/*--------------- F m t F i x e d ---------------
+Append v with a decimal point places digits from the right, so 1234 with 2
+places reads 12.34. There is always a digit ahead of the point.
+*/
+CPU_CHAR *FmtFixed(CPU_CHAR *p, CPU_INT32U v, CPU_INT08U places){
+  CPU_INT32U scale = 1;
+  CPU_INT32U frac;
+  CPU_INT08U i;
+  
+  for(i = 0; i < places; i++)
+    scale *= 10;
+  
+  p = FmtUDec(p, v / scale);
+  if(places){
+    *p++ = '.';
+    frac = v % scale;
+    // Pad the fraction out to places digits
+    for(scale /= 10; scale > 1 && frac < scale; scale /= 10)
+      *p++ = '0';
+    p = FmtUDec(p, frac);
+  }
+  
+  return p;
+}
+
+/*--------------- F m t B c d ---------------
+Append digits BCD digits from bcd, high nibble first, with a decimal point
+after the first point of them. A point of digits or more leaves it out.
+A nibble over 9 is written as its decimal value, as sprintf would.
+*/
+CPU_CHAR *FmtBcd(CPU_CHAR *p, const CPU_INT08U *bcd, CPU_INT08U digits,
+                 CPU_INT08U point){
+  CPU_INT08U i;
+  CPU_INT08U d;
+  
+  for(i = 0; i < digits; i++){
+    if(i == point)
+      *p++ = '.';
+    d = (i & 1) ? (bcd[i >> 1] & LowNibble) : (bcd[i >> 1] >> Nibble);
+    if(d < 10)
+      *p++ = '0' + d;
+    else
+      p = FmtUDec(p, d);
+  }
+  *p = '\0';
+  
+  return p;
+}
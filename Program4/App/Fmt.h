@@ -0,0 +1,32 @@
+/*--------------- F m t . h ---------------
+
+by: Michael Nickelson
+
+PURPOSE - Header file
+Small text formatter for replies, used in place of sprintf. Each function
+appends to a string at p, terminates it and returns a pointer to the
+terminator, so calls chain. Nothing is kept between calls, so tasks may
+format at the same time.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Added FmtFixed
+10-19-2026 mn -  Added FmtUDec64
+*/
+
+#ifndef FMT_H
+#define FMT_H
+
+#include "includes.h"
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+CPU_CHAR *FmtStr(CPU_CHAR *p, const CPU_CHAR *s);
+CPU_CHAR *FmtChars(CPU_CHAR *p, const CPU_CHAR *s, CPU_INT16U n);
+CPU_CHAR *FmtUDec(CPU_CHAR *p, CPU_INT32U v);
+CPU_CHAR *FmtUDec64(CPU_CHAR *p, CPU_INT64U v);
+CPU_CHAR *FmtSDec(CPU_CHAR *p, CPU_INT32S v);
+CPU_CHAR *FmtFixed(CPU_CHAR *p, CPU_INT32U v, CPU_INT08U places);
+CPU_CHAR *FmtBcd(CPU_CHAR *p, const CPU_INT08U *bcd, CPU_INT08U digits,
+                 CPU_INT08U point);
+
+#endif
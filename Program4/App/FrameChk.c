@@ -0,0 +1,206 @@
+/*--------------- F r a m e C h k . c ---------------
+
+by: Michael Nickelson
+
+PURPOSE
+Frame validation kernels shared by the packet parser and the host decoding
+tools. A frame is good when the XOR of all of its bytes, preamble through
+checksum byte, is zero. The reduction is done a byte, a word or a vector
+register at a time; all three give the same result.
+With CRC framing a frame is good when the CRC-16 of all of its bytes,
+preamble through CRC, is zero. The target uses a byte-wide table; host
+batch decoding can use slice-by-8, which takes 8 bytes per step.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Added CRC-16/CCITT with byte table and slice-by-8 versions
+*/
+
+#include <string.h>
+#include "FrameChk.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+/* CRC-16/CCITT of each byte value, MSB first */
+const CPU_INT16U Crc16Table[256] = {
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+  0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+  0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+  0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+  0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+  0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+  0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+  0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+  0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+  0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+  0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+  0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+  0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+  0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+  0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+  0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+  0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+  0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+  0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+  0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+  0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+  0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+  0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+  0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+  0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+  0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+  0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+  0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+  0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+  0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+  0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+#if CrcSlice8
+/* crc16Slice[k][b] is the CRC of byte b followed by k zero bytes */
+static CPU_INT16U crc16Slice[8][256];
+#endif
+
+/*--------------- F r a m e X o r B y t e s ---------------
+XOR of n bytes, one byte at a time
+*/
+CPU_INT08U FrameXorBytes(const CPU_INT08U *p, CPU_INT32U n){
+  CPU_INT08U x = 0;
+
+  while(n--)
+    x ^= *p++;
+
+  return x;
+}
+
+/*--------------- F r a m e X o r W o r d s ---------------
+XOR of n bytes, 32 bits at a time. The word is folded down to a byte at
+the end. Loads go through memcpy so any alignment is fine; Cortex-M3 and
+x86 both turn it into a single load.
+*/
+CPU_INT08U FrameXorWords(const CPU_INT08U *p, CPU_INT32U n){
+  CPU_INT32U w = 0;
+  CPU_INT32U v;
+
+  for(; n >= 2*sizeof(v); n -= 2*sizeof(v), p += 2*sizeof(v)){
+    memcpy(&v, p, sizeof(v));
+    w ^= v;
+    memcpy(&v, p + sizeof(v), sizeof(v));
+    w ^= v;
+  }
+  if(n >= sizeof(v)){
+    memcpy(&v, p, sizeof(v));
+    w ^= v;
+    n -= sizeof(v);
+    p += sizeof(v);
+  }
+  w ^= w >> 16;
+  w ^= w >> 8;
+
+  return (CPU_INT08U) w ^ FrameXorBytes(p, n);
+}
+
+/*--------------- F r a m e X o r V e c t o r ---------------
+XOR of n bytes, 16 bytes at a time with SSE2. Short blocks, and targets
+without a vector unit, use the word version.
+*/
+CPU_INT08U FrameXorVector(const CPU_INT08U *p, CPU_INT32U n){
+#if defined(__SSE2__)
+  __m128i a = _mm_setzero_si128();
+  __m128i b = _mm_setzero_si128();
+
+  if(n < 32)
+    return FrameXorWords(p, n);
+
+  for(; n >= 32; n -= 32, p += 32){
+    a = _mm_xor_si128(a, _mm_loadu_si128((const __m128i *) p));
+    b = _mm_xor_si128(b, _mm_loadu_si128((const __m128i *) (p + 16)));
+  }
+  if(n >= 16){
+    a = _mm_xor_si128(a, _mm_loadu_si128((const __m128i *) p));
+    n -= 16;
+    p += 16;
+  }
+  a = _mm_xor_si128(a, b);
+  a = _mm_xor_si128(a, _mm_srli_si128(a, 8));
+  a = _mm_xor_si128(a, _mm_srli_si128(a, 4));
+
+  return FrameXorWords((const CPU_INT08U *) &a, 4) ^ FrameXorWords(p, n);
+#else
+  return FrameXorWords(p, n);
+#endif
+}
+
+/*--------------- F r a m e C r c 1 6 ---------------
+Fold n bytes into a CRC-16, one table lookup per byte
+*/
+CPU_INT16U FrameCrc16(CPU_INT16U crc, const CPU_INT08U *p, CPU_INT32U n){
+  while(n--)
+    crc = Crc16Byte(crc, *p++);
+
+  return crc;
+}
+
+#if CrcSlice8
+/*--------------- F r a m e C r c 1 6 I n i t ---------------
+Build the slice-by-8 tables. Call once before FrameCrc16Slice8 is used.
+*/
+void FrameCrc16Init(void){
+  CPU_INT16U b;
+  CPU_INT16U k;
+
+  for(b = 0; b < 256; b++){
+    crc16Slice[0][b] = Crc16Table[b];
+    for(k = 1; k < 8; k++)
+      crc16Slice[k][b] = Crc16Byte(crc16Slice[k-1][b], 0);
+  }
+}
+
+/*--------------- F r a m e C r c 1 6 S l i c e 8 ---------------
+Fold n bytes into a CRC-16, 8 bytes per step. The 8 table lookups of a
+step are independent of each other, so they overlap in the pipeline.
+*/
+CPU_INT16U FrameCrc16Slice8(CPU_INT16U crc, const CPU_INT08U *p,
+                            CPU_INT32U n){
+  for(; n >= 8; n -= 8, p += 8){
+    crc ^= (p[0] << 8) | p[1];
+    crc = crc16Slice[7][crc >> 8] ^ crc16Slice[6][crc & 0xFF] ^
+          crc16Slice[5][p[2]] ^ crc16Slice[4][p[3]] ^
+          crc16Slice[3][p[4]] ^ crc16Slice[2][p[5]] ^
+          crc16Slice[1][p[6]] ^ crc16Slice[0][p[7]];
+  }
+
+  return FrameCrc16(crc, p, n);
+}
+#endif
+
+/*--------------- F r a m e C h e c k ---------------
+If p holds a complete good frame within avail bytes, return its length,
+otherwise return 0. crc selects CRC framing over the XOR checksum. The
+preamble and length byte are looked at before any checksum work is done.
+*/
+CPU_INT16U FrameCheck(const CPU_INT08U *p, CPU_INT32U avail,
+                      CPU_BOOLEAN crc){
+  CPU_INT16U len;
+
+  if(avail < HeaderLength ||
+     p[0] != Preamble1 || p[1] != Preamble2 || p[2] != Preamble3)
+    return 0;
+  len = p[HeaderLength-1];
+  if(len < HeaderLength + MinBodyLength + (crc ? CrcLength : ChkLength) ||
+     len > avail)
+    return 0;
+
+  if(crc)
+#if CrcSlice8
+    return FrameCrc16Slice8(CrcInit, p, len) ? 0 : len;
+#else
+    return FrameCrc16(CrcInit, p, len) ? 0 : len;
+#endif
+
+  return FrameXor(p, len) ? 0 : len;
+}
@@ -0,0 +1,91 @@
+/*--------------- F r a m e C h k . h ---------------
+
+by: Michael Nickelson
+
+PURPOSE - Header file
+Frame layout and frame validation kernels shared by the packet parser and
+the host decoding tools. The kernels take a whole frame in memory, so the
+tools check captured frames with the same code the parser checks packets
+with.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Added optional CRC-16/CCITT framing
+*/
+
+#ifndef FRAMECHK_H
+#define FRAMECHK_H
+
+#include "includes.h"
+
+/* Set FrameCrc to 1 to frame packets with a CRC-16/CCITT instead of the
+   XOR checksum byte */
+#ifndef FrameCrc
+#define FrameCrc 0
+#endif
+
+/* Set CrcSlice8 to 1 to build the slice-by-8 CRC. Its tables take 4K of
+   RAM, so it is meant for host builds. */
+#ifndef CrcSlice8
+#define CrcSlice8 0
+#endif
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+/* Frame layout: preamble, length byte, body, then either a checksum byte
+   or a big-endian CRC-16. The length byte counts the whole frame. */
+#define Preamble1 0x03
+#define Preamble2 0xEF
+#define Preamble3 0xAF
+#define HeaderLength 4
+#define MinBodyLength 3       /* Destination, source and message type */
+#define ChkLength 1
+#define CrcLength 2
+#define MaxFrameLen 255
+
+/* CRC-16/CCITT: polynomial 0x1021, initial value 0xFFFF. Run over a whole
+   frame including its CRC it comes out as 0. */
+#define CrcInit 0xFFFF
+
+/* Integrity check used by the target build */
+#if FrameCrc
+#define TrailerLength CrcLength
+#define ChkInit CrcInit
+#define ChkByte(chk, c) Crc16Byte(chk, c)
+#define ChkRun(chk, p, n) FrameCrc16(chk, p, n)
+#else
+#define TrailerLength ChkLength
+#define ChkInit 0
+#define ChkByte(chk, c) ((chk) ^ (c))
+#define ChkRun(chk, p, n) ((chk) ^ FrameXor(p, n))
+#endif
+
+#define ShortestPacket (HeaderLength + MinBodyLength + TrailerLength)
+
+/* Fold one byte into a CRC-16 */
+#define Crc16Byte(crc, c) \
+  ((CPU_INT16U) (((crc) << 8) ^ Crc16Table[(((crc) >> 8) ^ (c)) & 0xFF]))
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+extern const CPU_INT16U Crc16Table[256];
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+CPU_INT08U FrameXorBytes(const CPU_INT08U *p, CPU_INT32U n);
+CPU_INT08U FrameXorWords(const CPU_INT08U *p, CPU_INT32U n);
+CPU_INT08U FrameXorVector(const CPU_INT08U *p, CPU_INT32U n);
+CPU_INT16U FrameCrc16(CPU_INT16U crc, const CPU_INT08U *p, CPU_INT32U n);
+#if CrcSlice8
+void FrameCrc16Init(void);
+CPU_INT16U FrameCrc16Slice8(CPU_INT16U crc, const CPU_INT08U *p,
+                            CPU_INT32U n);
+#endif
+CPU_INT16U FrameCheck(const CPU_INT08U *p, CPU_INT32U avail,
+                      CPU_BOOLEAN crc);
+
+/* Fastest XOR reduction for the build target */
+#if defined(__SSE2__)
+#define FrameXor FrameXorVector
+#else
+#define FrameXor FrameXorWords
+#endif
+
+#endif
@@ -0,0 +1,238 @@
+/*--------------- L a t H i s t . c ---------------
+
+by: Michael Nickelson
+
+PURPOSE
+End to end latency histograms per message type.
+The reply task marks each reply before sending it with the receive time
+of its packet and where its last byte will fall in the transmit stream.
+The serial interrupt counts bytes as they leave the UART and time stamps
+the marker when its last byte goes. Stamped markers are folded into the
+histograms by the reply task as it marks, and by the payload task as it
+reports, so the interrupt does no more than a compare and a time stamp.
+Buckets are log-linear: four per power of two microseconds, so the
+percentiles read back are within 25%.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Report built with Fmt instead of sprintf, returns its end
+10-19-2026 mn -  Marked by the reply task, folding guarded from the payload
+                 task
+10-19-2026 mn -  Histogram per message type of MsgDefs.h
+*/
+
+#include "includes.h"
+#include "LatHist.h"
+#include "Clock.h"
+#include "Fmt.h"
+#include "MsgDefs.h"
+
+#if LATENCY_HIST
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define NumMarks 16             /* Replies in flight, a power of 2 */
+#define SubBits 2               /* Buckets per octave is 1 << SubBits */
+#define MinOctave 8             /* Below 256us goes in bucket 0 */
+#define MaxOctave 25            /* 32s and up go in the last bucket */
+#define NumBuckets (((MaxOctave - MinOctave + 1) << SubBits) + 1)
+#define P50 50
+#define P99 99
+#define Percent 100
+#define LatTypes sizeof(latTyped)  /* Up to the last type of MsgDefs.h */
+
+/* Histogram kept for msgType: its own for the types of MsgDefs.h, 0 for
+   everything else */
+#define LatType(msgType) \
+  (((msgType) < LatTypes && latTyped[msgType]) ? (msgType) : 0)
+
+/*----- t y p e d e f s   u s e d   i n   L a t H i s t -----*/
+typedef struct{
+  CPU_INT32U end;               // Bytes sent once the reply is out
+  CPU_TS rxTs;
+  CPU_TS txTs;                  // Set by the interrupt
+  CPU_INT08U msgType;
+} LatMark;
+
+typedef struct{
+  CPU_INT32U count[NumBuckets];
+  CPU_INT32U max;               // Microseconds
+  CPU_INT32U total;
+} LatHist;
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+// TRUE for each message type of MsgDefs.h, by its number
+#define MSG_LAT_TYPE(constant, type, Name, key, minData, maxData) [type] = TRUE,
+static const CPU_BOOLEAN latTyped[] = {MSG_LIST(MSG_LAT_TYPE)};
+#undef MSG_LAT_TYPE
+
+// Markers from markTail to markDone are stamped and waiting to be folded,
+// markDone to markHead are waiting for their last byte to be sent
+static LatMark marks[NumMarks];
+static volatile CPU_INT32U markHead;
+static volatile CPU_INT32U markDone;
+static CPU_INT32U markTail;
+
+// Bytes queued by the payload task and sent by the interrupt
+static CPU_INT32U bytesQueued;
+static CPU_INT32U bytesSent;
+
+static LatHist hist[LatTypes];
+static CPU_INT32U marksDropped;
+
+/*----- l o c a l   f u n c t i o n    p r o t o t y p e s -----*/
+static void LatFold(void);
+static CPU_INT16U LatBucket(CPU_INT32U us);
+static CPU_INT32U LatBucketTop(CPU_INT16U b);
+static CPU_INT32U LatPercentile(LatHist *h, CPU_INT08U pct);
+
+/*--------------- L a t H i s t M a r k ---------------
+Called by the reply task before it sends a replyLen byte reply to a
+packet of msgType received at rxTs
+*/
+void LatHistMark(CPU_INT08U msgType, CPU_TS rxTs, CPU_INT16U replyLen){
+  LatMark *m;
+  
+  LatFold();
+  
+  bytesQueued += replyLen;
+  if(markHead - markTail >= NumMarks){
+    // Every slot is in use, so this reply goes unmeasured
+    marksDropped++;
+    return;
+  }
+  
+  m = &marks[markHead & (NumMarks - 1)];
+  m->end = bytesQueued;
+  m->rxTs = rxTs;
+  m->msgType = LatType(msgType);
+  // Publish the marker only once it is filled in
+  markHead++;
+}
+
+/*--------------- L a t H i s t T x B y t e ---------------
+Called from the serial interrupt after each byte is written to the UART.
+The stamp comes a character time or two before the byte is on the line,
+see LatHist.h.
+*/
+void LatHistTxByte(void){
+  bytesSent++;
+  
+  while(markDone != markHead &&
+        (CPU_INT32S) (bytesSent - marks[markDone & (NumMarks - 1)].end) >= 0){
+    marks[markDone & (NumMarks - 1)].txTs = CPU_TS_Get32();
+    markDone++;
+  }
+}
+
+/*--------------- L a t H i s t R e p o r t ---------------
+Write count, median, 99th percentile and maximum latency for msgType into
+reply and return its end
+*/
+CPU_CHAR *LatHistReport(CPU_INT08U msgType, CPU_CHAR reply[]){
+  LatHist *h = &hist[LatType(msgType)];
+  CPU_CHAR *p;
+  
+  LatFold();
+  
+  p = FmtStr(reply, "\nLATENCY TYPE ");
+  p = FmtUDec(p, msgType);
+  p = FmtStr(p, ": n=");
+  p = FmtUDec(p, h->total);
+  p = FmtStr(p, " p50=");
+  p = FmtUDec(p, LatPercentile(h, P50));
+  p = FmtStr(p, " p99=");
+  p = FmtUDec(p, LatPercentile(h, P99));
+  p = FmtStr(p, " max=");
+  p = FmtUDec(p, h->max);
+  p = FmtStr(p, " us lost=");
+  p = FmtUDec(p, marksDropped);
+  return FmtStr(p, "\n");
+}
+
+/*--------------- L a t F o l d ---------------
+Move the latencies of stamped markers into the histograms. The reply and
+payload tasks both fold, so it runs with interrupts off; there are at
+most NumMarks markers to move.
+*/
+static void LatFold(void){
+  CPU_ERR cpuErr;
+  CPU_TS tsPerUs = CPU_TS_TmrFreqGet(&cpuErr) / UsPerSec;
+  LatMark *m;
+  LatHist *h;
+  CPU_INT32U us;
+  CPU_SR_ALLOC();
+  
+  CPU_CRITICAL_ENTER();
+  while(markTail != markDone){
+    m = &marks[markTail & (NumMarks - 1)];
+    us = (m->txTs - m->rxTs) / tsPerUs;
+    h = &hist[m->msgType];
+    h->count[LatBucket(us)]++;
+    h->total++;
+    if(us > h->max)
+      h->max = us;
+    markTail++;
+  }
+  CPU_CRITICAL_EXIT();
+}
+
+/*--------------- L a t B u c k e t ---------------
+Return the bucket for a latency of us microseconds
+*/
+static CPU_INT16U LatBucket(CPU_INT32U us){
+  CPU_INT16U octave = 0;
+  CPU_INT32U v;
+  
+  if(us < (1UL << MinOctave))
+    return 0;
+  
+  for(v = us; v > 1; v >>= 1)
+    octave++;
+  if(octave > MaxOctave)
+    return NumBuckets - 1;
+  
+  // The bits below the top one pick the bucket within the octave
+  return 1 + ((octave - MinOctave) << SubBits) +
+         ((us >> (octave - SubBits)) & ((1 << SubBits) - 1));
+}
+
+/*--------------- L a t B u c k e t T o p ---------------
+Return the largest latency in microseconds that falls in bucket b
+*/
+static CPU_INT32U LatBucketTop(CPU_INT16U b){
+  CPU_INT16U octave;
+  CPU_INT32U sub;
+  
+  if(b == 0)
+    return (1UL << MinOctave) - 1;
+  
+  octave = MinOctave + ((b - 1) >> SubBits);
+  sub = (b - 1) & ((1 << SubBits) - 1);
+  
+  return (1UL << octave) + ((sub + 1) << (octave - SubBits)) - 1;
+}
+
+/*--------------- L a t P e r c e n t i l e ---------------
+Return the top of the bucket holding the pct percentile of h
+*/
+static CPU_INT32U LatPercentile(LatHist *h, CPU_INT08U pct){
+  CPU_INT32U want;
+  CPU_INT32U seen = 0;
+  CPU_INT16U b;
+  
+  if(h->total == 0)
+    return 0;
+  
+  // Rank of the sample at pct, rounded up
+  want = (h->total * pct + Percent - 1) / Percent;
+  for(b = 0; b < NumBuckets; b++){
+    seen += h->count[b];
+    if(seen >= want)
+      break;
+  }
+  
+  return (b < NumBuckets - 1 && LatBucketTop(b) < h->max) ? 
+         LatBucketTop(b) : h->max;
+}
+
+#endif
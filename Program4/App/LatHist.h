@@ -0,0 +1,37 @@
+/*--------------- L a t H i s t . h ---------------
+
+by: Michael Nickelson
+
+PURPOSE - Header file
+End to end latency histograms, from the first preamble byte of a packet
+arriving to the last byte of its reply leaving the UART, kept per message
+type. Built only when LATENCY_HIST is 1.
+The last byte is stamped when it is written to the UART's data register,
+not when it has been shifted out. It is still waiting for the byte ahead
+of it and then takes its own character time on the line. So the figures
+read low by one to two character times, 1 to 2 ms at 9600 baud.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  LatHistReport returns the end of the report
+10-19-2026 mn -  Message types taken from MsgDefs.h, stamp error noted
+*/
+
+#ifndef LATHIST_H
+#define LATHIST_H
+
+#include "includes.h"
+
+/* Set LATENCY_HIST to 1 to build the latency histograms */
+#ifndef LATENCY_HIST
+#define LATENCY_HIST 0
+#endif
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+#if LATENCY_HIST
+void LatHistMark(CPU_INT08U msgType, CPU_TS rxTs, CPU_INT16U replyLen);
+void LatHistTxByte(void);
+CPU_CHAR *LatHistReport(CPU_INT08U msgType, CPU_CHAR reply[]);
+#endif
+
+#endif
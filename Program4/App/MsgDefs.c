@@ -0,0 +1,162 @@
+/*--------------- M s g D e f s . c ---------------
+
+by: Michael Nickelson
+
+PURPOSE
+Message definitions built from the lists in MsgDefs.h, and the field
+readers and the encoder that work from them. The encoder builds the data
+part of test traffic on the host, where CapGen and CapDecode link this
+file as the firmware does.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Encoder stores big endian fields through Endian.h
+*/
+
+#include "includes.h"
+#include "MsgDefs.h"
+#include "string.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define ByteMask 0xFF
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+/* Fields of each message */
+#define FLD_ENTRY(Name, Field, key, kind, offset, a, b) \
+  {key, FLD_##kind, offset, a, b},
+#define MSG_FIELDS(constant, type, Name, key, minData, maxData) \
+  static const MsgField Name##Fields[] = {Name##_FIELDS(FLD_ENTRY)};
+MSG_LIST(MSG_FIELDS)
+#undef MSG_FIELDS
+#undef FLD_ENTRY
+
+/* The messages */
+#define MSG_DEF(constant, type, Name, key, minData, maxData) \
+  const MsgDef Name##Def = {type, key, minData, maxData, Name##Fields, \
+                            sizeof(Name##Fields) / sizeof(MsgField)};
+MSG_LIST(MSG_DEF)
+#undef MSG_DEF
+
+#define MSG_PTR(constant, type, Name, key, minData, maxData) &Name##Def,
+static const MsgDef *const Defs[] = {MSG_LIST(MSG_PTR)};
+#undef MSG_PTR
+
+/*--------------- M s g F i n d ---------------
+Return the definition of a message type, or NULL if it has none
+*/
+const MsgDef *MsgFind(CPU_INT08U type){
+  CPU_INT08U i;
+  
+  for(i = 0; i < sizeof(Defs) / sizeof(Defs[0]); i++)
+    if(Defs[i]->type == type)
+      return Defs[i];
+  
+  return NULL;
+}
+
+/*--------------- M s g B c d ---------------
+Return the value of digits BCD digits, high nibble first
+*/
+CPU_INT16U MsgBcd(const CPU_INT08U *bcd, CPU_INT08U digits){
+  CPU_INT16U v = 0;
+  CPU_INT08U i;
+  
+  for(i = 0; i < digits; i++)
+    v = v * BcdBase + ((i & 1) ? (bcd[i >> 1] & LowNibble) : 
+                                 (bcd[i >> 1] >> Nibble));
+  
+  return v;
+}
+
+/*--------------- M s g V a l u e ---------------
+Return the value of a numeric field of the data part at data
+*/
+CPU_INT32S MsgValue(const MsgField *f, const CPU_INT08U *data){
+  const CPU_INT08U *p = data + f->offset;
+  
+  switch(f->kind){
+    case(FLD_S8):
+      return FLD_GET_S8(p, f->a, f->b);
+    case(FLD_U8):
+      return FLD_GET_U8(p, f->a, f->b);
+    case(FLD_U16):
+      return FLD_GET_U16(p, f->a, f->b);
+    case(FLD_BCD):
+      return FLD_GET_BCD(p, f->a, f->b);
+    case(FLD_BITS):
+      return FLD_GET_BITS(p, f->a, f->b);
+    default:
+      return 0;
+  }
+}
+
+/*--------------- M s g W i d t h ---------------
+Return the bytes a numeric field takes in a binary reply
+*/
+CPU_INT08U MsgWidth(const MsgField *f){
+  switch(f->kind){
+    case(FLD_S8):
+    case(FLD_U8):
+      return 1;
+    case(FLD_BITS):
+      return (f->b > ByteMask) ? 2 : 1;
+    default:
+      return 2;
+  }
+}
+
+/*--------------- M s g E n c o d e ---------------
+Write the data part of message m at data from the values of its numeric
+fields, in field order, and return its length. Values are cut to fit
+their fields. String fields take no value and are left to the caller;
+the length returned stops where they start.
+*/
+CPU_INT08U MsgEncode(const MsgDef *m, CPU_INT08U *data,
+                     const CPU_INT32S values[]){
+  const MsgField *f;
+  CPU_INT08U len = 0;
+  CPU_INT08U end;
+  CPU_INT32U v;
+  CPU_INT32U w;
+  CPU_INT08U i;
+  CPU_INT08U d;
+  
+  // Bit fields share their word, so start from zeros
+  memset(data, 0, m->minData);
+  for(i = 0; i < m->numFields; i++){
+    f = &m->fields[i];
+    v = values[i];
+    end = f->offset;
+    switch(f->kind){
+      case(FLD_S8):
+      case(FLD_U8):
+        data[end++] = v;
+        break;
+      case(FLD_U16):
+        EndianPut16BE(data + end, v);
+        end += sizeof(CPU_INT16U);
+        break;
+      case(FLD_BCD):
+        // Digits from the last, into the low nibble first
+        for(d = f->a; d-- > 0; v /= BcdBase){
+          if(d & 1)
+            data[f->offset + (d >> 1)] = v % BcdBase;
+          else
+            data[f->offset + (d >> 1)] |= v % BcdBase << Nibble;
+        }
+        end += (f->a + 1) / 2;
+        break;
+      case(FLD_BITS):
+        w = MsgGet32(data + end) | (v & f->b) << f->a;
+        EndianPut32BE(data + end, w);
+        end += sizeof(CPU_INT32U);
+        break;
+      default:
+        break;
+    }
+    if(end > len)
+      len = end;
+  }
+  
+  return len;
+}
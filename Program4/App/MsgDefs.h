@@ -0,0 +1,188 @@
+/*--------------- M s g D e f s . h ---------------
+
+by: Michael Nickelson
+
+PURPOSE - Header file
+Layout of the sensor reading messages, defined once. MSG_LIST names each
+message type and <Name>_FIELDS lists its fields, in the order the binary
+and line replies give them. From these lists come
+  - the message type numbers, MSG_TEMP and so on
+  - an offset constant, <Name><Field>Offset, for each field
+  - an accessor, Get<Name><Field>(data), reading a field in place from the
+    data part of a packet, big endian as it is sent
+  - a MsgDef describing each message, <Name>Def, for the formatters and
+    the host encoder in MsgDefs.c
+CapGen and CapDecode build from the same lists, so the test traffic and
+its decoding on the host follow the layout the firmware reads.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Big endian fields read with one load and byte swap
+10-19-2026 mn -  BCD digit constants shared by the modules that read BCD
+                 fields
+*/
+
+#ifndef MSGDEFS_H
+#define MSGDEFS_H
+
+#include "Endian.h"
+#include "FrameChk.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define IDLength 10
+#define WindSpeedDigits 4       /* BCD, one decimal place */
+#define WindSpeedPlaces 1
+#define PrecipDigits 4          /* BCD, two decimal places */
+#define PrecipPlaces 2
+
+/* BCD fields hold two digits a byte, the high nibble first */
+#define BcdBase 10
+#define Nibble 4
+#define LowNibble 0xF
+
+/* Fields of the packed date/time word */
+#define YearPosition 9
+#define YearMask 0xFFF
+#define MonthPosition 5
+#define MonthMask 0xF
+#define DayPosition 0
+#define DayMask 0x1F
+#define HourPosition 27
+#define HourMask 0x1F
+#define MinutePosition 21
+#define MinuteMask 0x3F
+
+/* Longest data part a frame has room for. Fixed size messages may be this
+   long; bytes past their fields are ignored. */
+#define MsgOpen (MaxFrameLen - HeaderLength - TrailerLength - MinBodyLength)
+
+/* MSG(constant, type, Name, key, minData, maxData)
+   key is the type field of line replies. minData and maxData bound the
+   data part, after the destination, source and type bytes. */
+#define MSG_LIST(MSG) \
+  MSG(MSG_TEMP,          1, Temp,      "temp",   1, MsgOpen) \
+  MSG(MSG_PRESSURE,      2, Pressure,  "pres",   2, MsgOpen) \
+  MSG(MSG_HUMIDITY,      3, Humidity,  "hum",    2, MsgOpen) \
+  MSG(MSG_WIND,          4, Wind,      "wind",   4, MsgOpen) \
+  MSG(MSG_RADIATION,     5, Radiation, "rad",    2, MsgOpen) \
+  MSG(MSG_TIMESTAMP,     6, TimeStamp, "time",   4, MsgOpen) \
+  MSG(MSG_PRECIPITATION, 7, Precip,    "precip", 2, MsgOpen) \
+  MSG(MSG_SENSORID,      8, ID,        "id",     0, IDLength)
+
+/* F(Name, Field, key, kind, offset, a, b)
+   kind   on the wire                    a          b
+   S8     signed byte
+   U8     unsigned byte
+   U16    big endian 16 bits
+   BCD    BCD digits, high nibble first  digits     decimal places
+   BITS   bits of a big endian 32 bits   position   mask
+   STR    characters to the body end     most characters */
+#define Temp_FIELDS(F) \
+  F(Temp,      Temp,  "temp",  S8,   0, 0, 0)
+#define Pressure_FIELDS(F) \
+  F(Pressure,  Pres,  "pres",  U16,  0, 0, 0)
+#define Humidity_FIELDS(F) \
+  F(Humidity,  DewPt, "dewpt", S8,   0, 0, 0) \
+  F(Humidity,  Hum,   "hum",   U8,   1, 0, 0)
+#define Wind_FIELDS(F) \
+  F(Wind,      Speed, "speed", BCD,  0, WindSpeedDigits, WindSpeedPlaces) \
+  F(Wind,      Dir,   "dir",   U16,  2, 0, 0)
+#define Radiation_FIELDS(F) \
+  F(Radiation, Rad,   "rad",   U16,  0, 0, 0)
+#define TimeStamp_FIELDS(F) \
+  F(TimeStamp, Year,  "year",  BITS, 0, YearPosition, YearMask) \
+  F(TimeStamp, Month, "month", BITS, 0, MonthPosition, MonthMask) \
+  F(TimeStamp, Day,   "day",   BITS, 0, DayPosition, DayMask) \
+  F(TimeStamp, Hour,  "hour",  BITS, 0, HourPosition, HourMask) \
+  F(TimeStamp, Min,   "min",   BITS, 0, MinutePosition, MinuteMask)
+#define Precip_FIELDS(F) \
+  F(Precip,    Depth, "depth", BCD,  0, PrecipDigits, PrecipPlaces)
+#define ID_FIELDS(F) \
+  F(ID,        Id,    "id",    STR,  0, IDLength, 0)
+
+/*----- t y p e d e f s   u s e d   b y   t h e   m e s s a g e s -----*/
+typedef enum {FLD_S8, FLD_U8, FLD_U16, FLD_BCD, FLD_BITS, FLD_STR} MsgKind_t;
+
+typedef struct
+{
+  const CPU_CHAR *key;          // Name in line replies
+  MsgKind_t kind;
+  CPU_INT08U offset;            // In the data part
+  CPU_INT08U a;                 // See the field lists
+  CPU_INT16U b;
+} MsgField;
+
+typedef struct
+{
+  CPU_INT08U type;
+  const CPU_CHAR *key;
+  CPU_INT08U minData;
+  CPU_INT08U maxData;
+  const MsgField *fields;
+  CPU_INT08U numFields;
+} MsgDef;
+
+/* Message type numbers */
+#define MSG_ENUM(constant, type, Name, key, minData, maxData) constant = type,
+enum {MSG_LIST(MSG_ENUM)};
+#undef MSG_ENUM
+
+/* Field offsets */
+#define FLD_OFFSET(Name, Field, key, kind, offset, a, b) \
+  Name##Field##Offset = offset,
+#define MSG_OFFSETS(constant, type, Name, key, minData, maxData) \
+  Name##_FIELDS(FLD_OFFSET)
+enum {MSG_LIST(MSG_OFFSETS)};
+#undef MSG_OFFSETS
+#undef FLD_OFFSET
+
+/* Message definitions, in MsgDefs.c */
+#define MSG_EXTERN(constant, type, Name, key, minData, maxData) \
+  extern const MsgDef Name##Def;
+MSG_LIST(MSG_EXTERN)
+#undef MSG_EXTERN
+
+/*----- f i e l d   a c c e s s o r s -----*/
+/* C type and value of a field of each kind, read from the wire at p */
+#define FLD_TYPE_S8 CPU_INT08S
+#define FLD_TYPE_U8 CPU_INT08U
+#define FLD_TYPE_U16 CPU_INT16U
+#define FLD_TYPE_BCD CPU_INT16U
+#define FLD_TYPE_BITS CPU_INT16U
+#define FLD_TYPE_STR const CPU_CHAR *
+#define FLD_GET_S8(p, a, b) ((CPU_INT08S) (p)[0])
+#define FLD_GET_U8(p, a, b) ((p)[0])
+#define FLD_GET_U16(p, a, b) MsgGet16(p)
+#define FLD_GET_BCD(p, a, b) MsgBcd(p, a)
+#define FLD_GET_BITS(p, a, b) (MsgGet32(p) >> (a) & (b))
+#define FLD_GET_STR(p, a, b) ((const CPU_CHAR *) (p))
+
+#define FLD_ACCESSOR(Name, Field, key, kind, offset, a, b) \
+  static inline FLD_TYPE_##kind Get##Name##Field(const CPU_INT08U *data){ \
+    return FLD_GET_##kind(data + offset, a, b); \
+  }
+#define MSG_ACCESSORS(constant, type, Name, key, minData, maxData) \
+  Name##_FIELDS(FLD_ACCESSOR)
+
+static inline CPU_INT16U MsgGet16(const CPU_INT08U *p){
+  return EndianGet16BE(p);
+}
+
+static inline CPU_INT32U MsgGet32(const CPU_INT08U *p){
+  return EndianGet32BE(p);
+}
+
+CPU_INT16U MsgBcd(const CPU_INT08U *bcd, CPU_INT08U digits);
+
+MSG_LIST(MSG_ACCESSORS)
+#undef MSG_ACCESSORS
+#undef FLD_ACCESSOR
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+const MsgDef *MsgFind(CPU_INT08U type);
+CPU_INT32S MsgValue(const MsgField *f, const CPU_INT08U *data);
+CPU_INT08U MsgWidth(const MsgField *f);
+CPU_INT08U MsgEncode(const MsgDef *m, CPU_INT08U *data,
+                     const CPU_INT32S values[]);
+
+#endif
@@ -0,0 +1,141 @@
+/*--------------- N o d e C a c h e . c ---------------
+
+by: Michael Nickelson
+
+PURPOSE
+Latest reading of each message type from each source node. The table is
+indexed directly by source address and by the message's place in
+MSG_LIST, so an update or a read touches one entry.
+Types without fixed fields, minData 0, have nothing to keep and no slot.
+The payload task is the only writer. Each entry carries a sequence
+number, odd while an update is under way, that also counts the updates.
+A reader copies the entry between two reads of the number and keeps the
+copy if they match and are even. Entries are volatile, so the compiler
+keeps the accesses in program order, and a single Cortex-M3 core sees its
+own accesses in that order.
+No lock is taken, so a reader never holds up the payload task.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Receive times kept in milliseconds of the Clock
+10-19-2026 mn -  No slots for types without fixed fields
+*/
+
+#include "includes.h"
+#include "NodeCache.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define NumByteValues 256       /* Every value of a type or address byte */
+
+/* Place of each message in MSG_LIST */
+#define MSG_PLACE(constant, type, Name, key, minData, maxData) Place##Name,
+enum {MSG_LIST(MSG_PLACE) NumPlaces};
+#undef MSG_PLACE
+
+/* Cache slot of each message with fixed fields. A message without any
+   ends one below its own slot number, so the next message takes it. */
+#define MSG_SLOT(constant, type, Name, key, minData, maxData) \
+  Slot##Name, SlotEnd##Name = Slot##Name + ((minData) > 0) - 1,
+enum {MSG_LIST(MSG_SLOT) NumSlots};
+#undef MSG_SLOT
+
+/*----- t y p e d e f s   u s e d   b y   t h e   c a c h e -----*/
+typedef struct
+{
+  CPU_INT32U seq;               // Twice the updates, plus 1 during one
+  CPU_INT32U rxMs;
+  CPU_INT08U data[NodeCacheData];
+} NodeEntry;
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+static volatile NodeEntry cache[NodeCacheNodes][NumSlots];
+
+/* Place of each message type plus 1, 0 for types not cached */
+#define MSG_PLACE_OF(constant, type, Name, key, minData, maxData) \
+  [type] = ((minData) > 0) ? Place##Name + 1 : 0,
+static const CPU_INT08U PlaceOf[NumByteValues] = {MSG_LIST(MSG_PLACE_OF)};
+#undef MSG_PLACE_OF
+
+#define MSG_PLACE_DEF(constant, type, Name, key, minData, maxData) &Name##Def,
+static const MsgDef *const PlaceDef[NumPlaces] = {MSG_LIST(MSG_PLACE_DEF)};
+#undef MSG_PLACE_DEF
+
+#define MSG_PLACE_SLOT(constant, type, Name, key, minData, maxData) Slot##Name,
+static const CPU_INT08U PlaceSlot[NumPlaces] = {MSG_LIST(MSG_PLACE_SLOT)};
+#undef MSG_PLACE_SLOT
+
+/*--------------- N o d e C a c h e U p d a t e ---------------
+Keep a reading of msgType from src, with dataLen bytes of data received at
+rxMs. Readings of types not cached, from sources past NodeCacheNodes, or
+too short for their fields are ignored. Called by the payload task only.
+*/
+void NodeCacheUpdate(CPU_INT08U src, CPU_INT08U msgType,
+                     const CPU_INT08U *data, CPU_INT08U dataLen,
+                     CPU_INT32U rxMs){
+  CPU_INT08U place = PlaceOf[msgType];
+  volatile NodeEntry *e;
+  CPU_INT08U n;
+  CPU_INT08U i;
+
+  if(place == 0 || dataLen < PlaceDef[place-1]->minData)
+    return;
+#if NodeCacheNodes < NumByteValues
+  if(src >= NodeCacheNodes)
+    return;
+#endif
+  e = &cache[src][PlaceSlot[place-1]];
+  n = (PlaceDef[place-1]->minData < NodeCacheData) ?
+      PlaceDef[place-1]->minData : NodeCacheData;
+
+  e->seq++;
+  e->rxMs = rxMs;
+  for(i = 0; i < n; i++)
+    e->data[i] = data[i];
+  e->seq++;
+}
+
+/*--------------- N o d e C a c h e R e a d ---------------
+Copy the latest reading of msgType from src into r. Returns FALSE if
+there has been none, or if no consistent copy was had in NodeCacheTries.
+*/
+CPU_BOOLEAN NodeCacheRead(CPU_INT08U src, CPU_INT08U msgType,
+                          NodeReading *r){
+  CPU_INT08U place = PlaceOf[msgType];
+  volatile NodeEntry *e;
+  CPU_INT32U seq;
+  CPU_INT08U tries;
+  CPU_INT08U i;
+
+  if(place == 0)
+    return FALSE;
+#if NodeCacheNodes < NumByteValues
+  if(src >= NodeCacheNodes)
+    return FALSE;
+#endif
+  e = &cache[src][PlaceSlot[place-1]];
+
+  for(tries = 0; tries < NodeCacheTries; tries++){
+    seq = e->seq;
+    if(seq & 1)
+      continue;
+    r->rxMs = e->rxMs;
+    for(i = 0; i < NodeCacheData; i++)
+      r->data[i] = e->data[i];
+    if(e->seq == seq){
+      r->count = seq / 2;
+      return r->count > 0;
+    }
+  }
+
+  return FALSE;
+}
+
+/*--------------- N o d e C a c h e D e f ---------------
+Return the definition of a cached message type, or NULL if it is not
+cached
+*/
+const MsgDef *NodeCacheDef(CPU_INT08U msgType){
+  CPU_INT08U place = PlaceOf[msgType];
+
+  return (place == 0) ? NULL : PlaceDef[place-1];
+}
@@ -0,0 +1,58 @@
+/*--------------- N o d e C a c h e . h ---------------
+
+by: Michael Nickelson
+
+PURPOSE - Header file
+Latest reading of each message type from each source node, with the time
+it was received and how many have come. The payload task updates an entry
+in place for each good reading; any task may read one without a lock.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Receive times kept in milliseconds of the Clock
+10-19-2026 mn -  Types without fixed fields not cached
+*/
+
+#ifndef NODECACHE_H
+#define NODECACHE_H
+
+#include "includes.h"
+#include "MsgDefs.h"
+
+/* Source addresses cached, from 0. Each costs 12 bytes for each message
+   type of MsgDefs.h with fixed fields; readings from addresses past the
+   last are not kept. */
+#ifndef NodeCacheNodes
+#define NodeCacheNodes 256
+#endif
+
+/* Tries a reader makes at a consistent copy of an entry before giving up.
+   Only a reader above the payload task's priority, preempting it in the
+   middle of an update, can fail them all. */
+#ifndef NodeCacheTries
+#define NodeCacheTries 4
+#endif
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define NodeCacheData 4         /* Data bytes kept, the longest fixed reading */
+
+/*----- t y p e d e f s   u s e d   b y   t h e   c a c h e -----*/
+/* A copy of one entry. Data is laid out as the message's data part, see
+   MsgDefs.h; string fields are not kept. */
+typedef struct
+{
+  CPU_INT32U count;             // Readings received
+  CPU_INT32U rxMs;              // Receive time of the latest, the low 32
+                                // bits of the Clock in milliseconds
+  CPU_INT08U data[NodeCacheData];
+} NodeReading;
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void NodeCacheUpdate(CPU_INT08U src, CPU_INT08U msgType,
+                     const CPU_INT08U *data, CPU_INT08U dataLen,
+                     CPU_INT32U rxMs);
+CPU_BOOLEAN NodeCacheRead(CPU_INT08U src, CPU_INT08U msgType,
+                          NodeReading *r);
+const MsgDef *NodeCacheDef(CPU_INT08U msgType);
+
+#endif
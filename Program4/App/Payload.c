@@ -8,91 +8,137 @@ Parse payload and handle response
 CHANGES
 02-19-2014 mn -  Initial submission
 03-12-2014 mn -  Updated to use uCOS-III and semaphores
+10-19-2026 mn -  Status byte and unsigned body length ahead of each payload
+10-19-2026 mn -  Take records one at a time from a queue in the payload buffer
+10-19-2026 mn -  Local addresses come from AddrMap
+10-19-2026 mn -  Optional receive time line in replies
+10-19-2026 mn -  Diagnostic message type, latency histogram report
+10-19-2026 mn -  Parser statistics reports
+10-19-2026 mn -  Errors are counted over a window and reported in one line
+10-19-2026 mn -  Constant messages are sent from their tables, SendReply
+                 takes a length
+10-19-2026 mn -  Replies built with Fmt instead of sprintf
+10-19-2026 mn -  Binary reply format
+10-19-2026 mn -  CSV and JSON lines reply formats, format diagnostic command
+10-19-2026 mn -  Replies go through the reply queue, so the task never waits
+                 on the transmitter
+10-19-2026 mn -  Reply class statistics diagnostic command
+10-19-2026 mn -  Message types dispatched through a table of registered
+                 handlers, short bodies rejected before a handler runs
+10-19-2026 mn -  Reading layouts, field access and the binary and line
+                 replies come from the message lists in MsgDefs.h
+10-19-2026 mn -  Binary reply fields stored through Endian.h
+10-19-2026 mn -  Latest reading of each node kept in NodeCache, node
+                 reading diagnostic command
+10-19-2026 mn -  Receive times and reading ages from the 64 bit Clock
+10-19-2026 mn -  Handlers not taken for the binary reply types
+10-19-2026 mn -  Constant text replies sent from their tables, not copied
+10-19-2026 mn -  Stack sized from the deepest reply chain
 */
 
 #include "includes.h"
+#include "AddrMap.h"
 #include "Payload.h"
 #include "assert.h"
+#include "BinReply.h"
+#include "Clock.h"
+#include "Endian.h"
 #include "Error.h"
+#include "Fmt.h"
+#include "LatHist.h"
+#include "MsgDefs.h"
+#include "NodeCache.h"
 #include "PktParser.h"
-#include "SerIODriver.h"
+#include "ReplyQ.h"
 #include "string.h"
 
 /*----- c o n s t a n t    d e f i n i t i o n s -----*/
-#define LowNibble 0xF
-#define Nibble 4
+#define ReplyBfrSize 128        /* Longest text reply, with its terminator */
+#define LineOverhead 64         /* Head of a CSV or JSON line, and framing */
+#define ReplyMaxLength (ReplyBfrSize + LineOverhead)  /* In any format */
+#define PayloadPrio 4
+// Words of stack. The deepest chain found with gcc -fstack-usage is a
+// node reading in a CSV or JSON line: LineReply, ParseDiag, DiagNode and
+// the Clock's 64 bit division, 488 bytes with the divide allowed 64.
+// With the 64 bytes of an interrupt and a context switch on top that is
+// 138 words, past the old 128. The sizes came from a 32 bit x86 build,
+// as no ARM toolchain was to hand, so they get half again as margin.
+// Check it with OSTaskStkChk() on the board.
+#define PAYLOAD_STK_SIZE 256
+#define HIGH_WATER_LIMIT 10
 
-#define LowByte 0               /* For multibyte BCD message */
-#define HighByte 1              /* For multibyte BCD message */
+/*-----  Message types past the sensor readings of MsgDefs.h -----*/
+#define MSG_DIAG 9
 
-#define MyAddress 1
+/*-----  Diagnostic commands, the first data byte of MSG_DIAG -----*/
+#define DiagCmdOffset 0
+#define DiagArgOffset 1
+#define DiagTypeOffset 2
+#define DIAG_LATENCY 1          /* Argument is the message type */
+#define DIAG_STATS 2            /* Frame rate, skipped bytes and errors */
+#define DIAG_TYPE 3             /* Argument is the message type */
+#define DIAG_SOURCE 4           /* Argument is the source node */
+#define DIAG_FORMAT 5           /* Argument is a ReplyFormat_t */
+#define DIAG_REPLYQ 6           /* Argument, if any, is a ReplyDrop_t */
+#define DIAG_TXCLASS 7          /* Argument is a ReplyPrio_t */
+#define DIAG_NODE 8             /* Argument is the source node, then an */
+                                /* optional message type */
+#define Tenths 10
 
-#define WindSpeedLength 2
-#define PrecipLength 2
-#define IDLength 10
-#define MsgLength 160
-#define PayloadBfrSize 14
-#define ReplyBfrSize 80
-#define PayloadPrio 4
-#define PAYLOAD_STK_SIZE 128
-#define SUSPEND_TIMEOUT 0
-#define HIGH_WATER_LIMIT 10
+#if LineOverhead < BinOverhead
+#error "LineOverhead must cover the binary reply framing"
+#endif
 
-/*-----  Assign easy to read names to message ID -----*/
-#define MSG_TEMP 1
-#define MSG_PRESSURE 2
-#define MSG_HUMIDITY 3
-#define MSG_WIND 4
-#define MSG_RADIATION 5
-#define MSG_TIMESTAMP 6
-#define MSG_PRECIPITATION 7
-#define MSG_SENSORID 8
-
-/*----- t y p e d e f s   u s e d   i n   p a y l o a d   m o d u l e -----*/
-#pragma pack(1)
-typedef struct
-{
-  CPU_INT08S    payloadLen;
-  CPU_INT08U    dstAddr;
-  CPU_INT08U    srcAddr;
-  CPU_INT08U    msgType;
-  union
-  {
-    CPU_INT08S  temp;
-    CPU_INT16U  pres;
-    struct
-    {
-      CPU_INT08S dewPt;
-      CPU_INT08U hum;
-    } hum;
-    struct
-    {
-      CPU_INT08U speed[WindSpeedLength];
-      CPU_INT16U dir;
-    } wind;
-    CPU_INT16U  rad;
-    CPU_INT32U  dateTime;
-    CPU_INT08U  depth[PrecipLength];
-    CPU_INT08U  id[IDLength];
-  } dataPart;
-} Payload;
-
-typedef enum { P, R } PayloadState;
+#if ReplyBlkSize < ReplyMaxLength
+#error "ReplyBlkSize must hold the longest reply"
+#endif
+
+/* Seconds over which errors are counted before they are reported. 0
+   reports each error as it comes. */
+#ifndef ErrWindow
+#define ErrWindow 5
+#endif
 
 /*----- l o c a l   f u n c t i o n    p r o t o t y p e s -----*/
 void PayloadInit(BfrPair **payloadBfrPair);
 void PayloadTask(void *data);
-void ParseTemp(Payload *payload, CPU_CHAR reply[]);
-void ParsePressure(Payload *payload, CPU_CHAR reply[]);
-void ParseHumidity(Payload *payload, CPU_CHAR reply[]);
-void ParseWind(Payload *payload, CPU_CHAR reply[]);
-void ParseRadiation(Payload *payload, CPU_CHAR reply[]);
-void ParseTimeStamp(Payload *payload, CPU_CHAR reply[]);
-void ParsePrecip(Payload *payload, CPU_CHAR reply[]);
-void ParseID(Payload *payload, CPU_CHAR reply[]);
-CPU_BOOLEAN SendReply(CPU_CHAR reply[]);
-CPU_INT16U Reverse2Bytes(CPU_INT16U b);
-CPU_INT32U Reverse4Bytes(CPU_INT32U b);
+CPU_CHAR *ParseTemp(Payload *payload, CPU_CHAR reply[]);
+CPU_CHAR *ParsePressure(Payload *payload, CPU_CHAR reply[]);
+CPU_CHAR *ParseHumidity(Payload *payload, CPU_CHAR reply[]);
+CPU_CHAR *ParseWind(Payload *payload, CPU_CHAR reply[]);
+CPU_CHAR *ParseRadiation(Payload *payload, CPU_CHAR reply[]);
+CPU_CHAR *ParseTimeStamp(Payload *payload, CPU_CHAR reply[]);
+CPU_CHAR *ParsePrecip(Payload *payload, CPU_CHAR reply[]);
+CPU_CHAR *ParseID(Payload *payload, CPU_CHAR reply[]);
+CPU_CHAR *ParseDiag(Payload *payload, CPU_CHAR reply[]);
+const MsgHandler *FindHandler(Payload *payload, Error_t *e);
+CPU_INT08U *BinFields(const MsgDef *m, Payload *payload, CPU_INT08U *p);
+CPU_CHAR *LineFields(const MsgDef *m, Payload *payload, CPU_CHAR *p);
+CPU_CHAR *DiagStats(CPU_CHAR reply[]);
+CPU_CHAR *DiagTxClass(ReplyPrio_t prio, CPU_CHAR reply[]);
+CPU_CHAR *DiagNode(CPU_INT08U src, CPU_INT08U msgType, CPU_CHAR reply[]);
+CPU_CHAR *AddRxTime(Payload *payload, CPU_CHAR *p);
+ReplyPrio_t ReplyPrio(Payload *payload);
+CPU_CHAR *TextReply(Payload *payload, CPU_CHAR reply[], const Msg_t **msg);
+CPU_INT08U *BinReply(Payload *payload, CPU_INT08U frame[]);
+CPU_CHAR *LineReply(Payload *payload, CPU_CHAR reply[]);
+CPU_CHAR *LineOpen(CPU_CHAR *p, CPU_INT64U us, CPU_INT08U src,
+                   const CPU_CHAR *type);
+CPU_CHAR *LineKey(CPU_CHAR *p, const CPU_CHAR *key);
+CPU_CHAR *LineStr(CPU_CHAR *p, const CPU_CHAR *s, CPU_INT16U n);
+CPU_CHAR *LineText(CPU_CHAR *p, const CPU_CHAR *text);
+CPU_CHAR *LineClose(CPU_CHAR *p);
+CPU_INT08U *BinOpen(CPU_INT08U frame[], CPU_INT08U src, CPU_INT08U type,
+                    Payload *payload);
+CPU_INT08U *BinClose(CPU_INT08U frame[], CPU_INT08U *end);
+CPU_INT08U *BinPut16(CPU_INT08U *p, CPU_INT16U v);
+CPU_INT08U *BinPut32(CPU_INT08U *p, CPU_INT32U v);
+CPU_INT64U RxTimeUs(Payload *payload);
+void CountErr(Error_t e);
+CPU_BOOLEAN ErrSummaryDue(OS_TICK *wait);
+CPU_CHAR *ErrSummary(CPU_CHAR reply[]);
+CPU_CHAR *ErrSummaryText(CPU_CHAR reply[], CPU_INT32U preamble,
+                         CPU_INT32U secs);
 
 /*----- G l o b a l   V a r i a b l e s -----*/
 // Payload buffer pair
@@ -100,6 +146,47 @@ BfrPair payloadBfrPair;
 static CPU_INT08U pBfr0Space[PayloadBfrSize];
 static CPU_INT08U pBfr1Space[PayloadBfrSize];
 
+// Add the receive time to each reply
+static volatile CPU_BOOLEAN timestamps = FALSE;
+
+// Format of the replies, and the one asked for. A new format is taken up
+// between replies so that none comes out half in each.
+static ReplyFormat_t replyFormat = ReplyFormat;
+static volatile ReplyFormat_t newFormat = ReplyFormat;
+
+// Handlers of the sensor readings, from the message lists in MsgDefs.h.
+// Their binary and line replies are written field by field from the
+// message definition.
+#define MSG_HANDLER(constant, type, Name, key, minData, maxData) \
+  static CPU_INT08U *Bin##Name(Payload *payload, CPU_INT08U *p){ \
+    return BinFields(&Name##Def, payload, p); \
+  } \
+  static CPU_CHAR *Line##Name(Payload *payload, CPU_CHAR *p){ \
+    return LineFields(&Name##Def, payload, p); \
+  } \
+  static const MsgHandler Name##Handler = \
+    {MinBodyLength + minData, MinBodyLength + maxData, key, Parse##Name, \
+     Bin##Name, Line##Name};
+MSG_LIST(MSG_HANDLER)
+#undef MSG_HANDLER
+
+// Diagnostic commands reply in text in every format
+static const MsgHandler DiagHandler = 
+  {MinBodyLength + 1, MaxBodyLength, "diag", ParseDiag, NULL, NULL};
+
+// Handler of each message type, NULL for types with none
+static const MsgHandler *handlers[NumMsgTypes];
+
+// Errors counted since errStart, by -Error_t
+static volatile CPU_INT16U errWindow = ErrWindow;
+static CPU_INT32U errCount[NumErrors];
+static CPU_BOOLEAN errPending = FALSE;
+static OS_TICK errStart;
+
+// Replies the reply queue has no room for are built here and thrown away,
+// so that their errors are still counted
+static CPU_CHAR scratch[ReplyMaxLength];
+
 // Task TCB and stack
 static OS_TCB payloadTCB;
 static CPU_STK payloadStk[PAYLOAD_STK_SIZE];
@@ -143,215 +230,935 @@ void PayloadInit(BfrPair **pBfrPair){
      onto payloadBfrPair */
   BfrPairInit(&payloadBfrPair, pBfr0Space, pBfr1Space, PayloadBfrSize);
   *pBfrPair = &payloadBfrPair;
+  
+#define MSG_REGISTER(constant, type, Name, key, minData, maxData) \
+  PayloadRegister(constant, &Name##Handler);
+  MSG_LIST(MSG_REGISTER)
+#undef MSG_REGISTER
+  PayloadRegister(MSG_DIAG, &DiagHandler);
+}
+
+/*--------------- P a y l o a d R e g i s t e r ---------------
+Make handler the handler of msgType, replacing any it had. NULL leaves
+msgType without one, so its packets are replied to as unknown types.
+Types from BinText up are not taken: binary replies use BinText and
+BinError for text and errors and carry BinStamped in the type byte, so a
+reading of those types could not be told from them.
+*/
+void PayloadRegister(CPU_INT08U msgType, const MsgHandler *handler){
+  assert(msgType < BinText);
+  if(msgType < BinText)
+    handlers[msgType] = handler;
+}
+
+/*--------------- F i n d H a n d l e r ---------------
+Return the handler of a payload to this node. Return NULL, with the error
+in e, if its type has none or its body is too short or too long for it.
+*/
+const MsgHandler *FindHandler(Payload *payload, Error_t *e){
+  const MsgHandler *h = handlers[payload->msgType];
+  
+  if(h == NULL){
+    *e = ERR_MSG_TYPE;
+  }else if(payload->payloadLen < h->minLen || payload->payloadLen > h->maxLen){
+    *e = ERR_LEN;
+    h = NULL;
+  }
+  
+  return h;
+}
+
+/*--------------- P a y l o a d S e t T i m e s t a m p s ---------------
+Turn the receive time line in replies on or off
+*/
+void PayloadSetTimestamps(CPU_BOOLEAN on){
+  timestamps = on;
+}
+
+/*--------------- P a y l o a d S e t F o r m a t ---------------
+Select the format of the replies
+*/
+void PayloadSetFormat(ReplyFormat_t format){
+  newFormat = format;
+}
+
+/*--------------- P a y l o a d S e t E r r W i n d o w ---------------
+Set how many seconds errors are counted over before they are reported.
+0 reports each error as it comes.
+*/
+void PayloadSetErrWindow(CPU_INT16U seconds){
+  errWindow = seconds;
 }
 
 /*--------------- P a y l o a d T a s k ---------------
 Get a payload from payloadBfrPair and generate a reply based on message type 
-then forward it to the reply buffer
+in a reply queue block. A payload buffer holds a queue of records; they
+are taken one at a time and the buffer is given back once the last one
+has been read. The reply task sends the replies, so a slow serial line
+drops replies instead of holding up the parser.
 */
 void PayloadTask(void *data){
-  CPU_BOOLEAN replyDone = FALSE;
-  static PayloadState pState = P;
-  static CPU_CHAR reply[ReplyBfrSize];
+  CPU_BOOLEAN haveBfr = FALSE;
+  CPU_INT08U *record;
   Payload *payload;
+  const Msg_t *msg;
+  ReplyBlk *blk;
+  CPU_CHAR *reply;
+  CPU_CHAR *end;
+  OS_TICK wait;
   OS_ERR osErr;
   
   for(;;){
-    if(pState == P){ // If no reply is being sent check payload data ready conditions
-      // Wait here for a payload buffer to close
-      OSSemPend(&closedPayloadBfrs, SUSPEND_TIMEOUT, OS_OPT_PEND_BLOCKING, NULL, &osErr);
+    replyFormat = newFormat;
+    if(!haveBfr){
+      // Counted errors are reported once there is no data waiting
+      if(ErrSummaryDue(&wait)){
+        blk = ReplyQAlloc(PRIO_LOW);
+        reply = (blk != NULL) ? blk->text : scratch;
+        if(replyFormat == FMT_BINARY){
+          end = (CPU_CHAR *) BinOpen((CPU_INT08U *) reply, 0, BinText, NULL);
+          end = (CPU_CHAR *) BinClose((CPU_INT08U *) reply, 
+                                      (CPU_INT08U *) ErrSummary(end));
+        }else{
+          end = ErrSummary(reply);
+        }
+        if(blk != NULL){
+          blk->msgType = 0;
+          blk->rxTs = CPU_TS_Get32();
+          blk->len = end - reply;
+          ReplyQPost(blk);
+        }
+        continue;
+      }
+      // Wait here for a payload buffer to close, or for the error
+      // window to end. Waking at least every ClockUpdateSecs keeps the
+      // clock's count of timer wraps while the line is quiet.
+      if(wait == 0 || wait > ClockUpdateSecs * OSCfg_TickRate_Hz)
+        wait = ClockUpdateSecs * OSCfg_TickRate_Hz;
+      OSSemPend(&closedPayloadBfrs, wait, OS_OPT_PEND_BLOCKING, NULL, &osErr);
+      if(osErr == OS_ERR_TIMEOUT){
+        ClockUpdate();
+        continue;
+      }
       assert(osErr==OS_ERR_NONE);
-      payload = (Payload *) GetBfrAddr(&payloadBfrPair);
-      if(payload->payloadLen <= 0){  // Check for error cases
-        DispErr((Error_t) payload->payloadLen, reply);
+      haveBfr = TRUE;
+    }
+    GetBfrSpan(&payloadBfrPair, &record);
+    payload = (Payload *) record;
+    // Keep the latest reading of each node, whoever it was sent to
+    if(payload->status == 0)
+      NodeCacheUpdate(payload->srcAddr, payload->msgType, payload->data,
+                      payload->payloadLen - MinBodyLength,
+                      (CPU_INT32U) (RxTimeUs(payload) / UsPerMs));
+    blk = ReplyQAlloc(ReplyPrio(payload));
+    reply = (blk != NULL) ? blk->text : scratch;
+    msg = NULL;
+    switch(replyFormat){
+      case(FMT_BINARY):
+        end = (CPU_CHAR *) BinReply(payload, (CPU_INT08U *) reply);
+        break;
+      case(FMT_CSV):
+      case(FMT_JSON):
+        end = LineReply(payload, reply);
+        break;
+      default:
+        end = TextReply(payload, reply, &msg);
+        break;
+    }
+    if(blk != NULL){
+      // Nothing is sent for a counted error
+      if(end == reply && msg == NULL){
+        ReplyQFree(blk);
       }else{
-        if(payload->dstAddr == MyAddress){ // If message is to me, generate a response
-          switch(payload->msgType){
-            case(MSG_TEMP):
-              ParseTemp(payload, reply);
-              break;
-            case(MSG_PRESSURE):
-              ParsePressure(payload, reply);
-              break;
-            case(MSG_HUMIDITY):
-              ParseHumidity(payload, reply);
-              break;
-            case(MSG_WIND):
-              ParseWind(payload, reply);
-              break;
-            case(MSG_RADIATION):
-              ParseRadiation(payload, reply);
-              break;
-            case(MSG_TIMESTAMP):
-              ParseTimeStamp(payload, reply);
-              break;
-            case(MSG_PRECIPITATION):
-              ParsePrecip(payload, reply);
-              break;
-            case(MSG_SENSORID):
-              ParseID(payload, reply);
-              break;
-            default:  // Handle unknown message types
-              DispErr((Error_t) payload->msgType, reply);
-              break;
-          }
-        }else{ // Display an info message if another host is the target
-          DispAssert(ASS_ADDRESS, reply);
+        // Error and info replies are counted under message type 0
+        blk->msgType = (payload->status < 0 || 
+                        !AddrMapHas(payload->dstAddr)) ? 0 : payload->msgType;
+        blk->rxTs = payload->rxTs;
+        if(msg != NULL){
+          blk->msg = msg->text;
+          blk->len = msg->len;
+        }else{
+          blk->len = end - reply;
         }
+        ReplyQPost(blk);
       }
-      pState = R;
-      OpenGetBfr(&payloadBfrPair);
+    }
+    
+    // Skipping the last record opens the buffer
+    GetBfrSkip(&payloadBfrPair, PayloadHdrLength + payload->payloadLen);
+    if(!GetBfrClosed(&payloadBfrPair)){
+      haveBfr = FALSE;
       OSSemPost(&openPayloadBfrs, OS_OPT_POST_1, &osErr);
       assert(osErr==OS_ERR_NONE);
       if(BfrPairSwappable(&payloadBfrPair))
             BfrPairSwap(&payloadBfrPair);
+    }
+  }
+}
+
+/*--------------- R e p l y P r i o ---------------
+Return the priority of the reply to a payload. Diagnostics come first,
+then data. Errors and info about other hosts' messages come last, so they
+never hold up a reading.
+*/
+ReplyPrio_t ReplyPrio(Payload *payload){
+  if(payload->status < 0 || !AddrMapHas(payload->dstAddr))
+    return PRIO_LOW;
+  if(payload->msgType == MSG_DIAG)
+    return PRIO_HIGH;
+  return PRIO_NORMAL;
+}
+
+/*--------------- T e x t R e p l y ---------------
+Write the text reply to a payload and return its end. Counted errors get
+no reply, so the end is reply itself. An error or info reply is a
+constant message, returned in msg and sent from its table; it is copied
+to reply only when the receive time line is added to it.
+*/
+CPU_CHAR *TextReply(Payload *payload, CPU_CHAR reply[], const Msg_t **msg){
+  const MsgHandler *h;
+  Error_t e;
+  CPU_CHAR *end = reply;
+  
+  *msg = NULL;
+  if(payload->status < 0){  // Check for error cases
+    if(errWindow)
+      CountErr((Error_t) payload->status);
+    else
+      *msg = ErrMsg((Error_t) payload->status);
+  }else{
+    if(AddrMapHas(payload->dstAddr)){ // If message is to me, generate a response
+      if((h = FindHandler(payload, &e)) != NULL)
+        end = h->text(payload, reply);
+      else if(errWindow)
+        CountErr(e);
+      else
+        *msg = ErrMsg(e);
+    }else{ // Display an info message if another host is the target
+      *msg = AssertMsg(ASS_ADDRESS);
+    }
+  }
+  if(*msg != NULL && timestamps){
+    memcpy(reply, (*msg)->text, (*msg)->len);
+    end = reply + (*msg)->len;
+    *msg = NULL;
+  }
+  if(end != reply && timestamps)
+    end = AddRxTime(payload, end);
+  
+  return end;
+}
+
+/*--------------- B i n R e p l y ---------------
+Write the binary reply to a payload, laid out as BinReply.h describes, and
+return its end. Counted errors get no reply, so the end is frame itself.
+*/
+CPU_INT08U *BinReply(Payload *payload, CPU_INT08U frame[]){
+  const MsgHandler *h;
+  CPU_INT08U *p;
+  Error_t e;
+  
+  if(payload->status < 0){
+    if(errWindow){
+      CountErr((Error_t) payload->status);
+      return frame;
+    }
+    p = BinOpen(frame, 0, BinError, payload);
+    *p++ = payload->status;
+    return BinClose(frame, p);
+  }
+  if(!AddrMapHas(payload->dstAddr)){
+    p = BinOpen(frame, payload->srcAddr, BinError, payload);
+    *p++ = ASS_ADDRESS;
+    return BinClose(frame, p);
+  }
+  if((h = FindHandler(payload, &e)) == NULL){
+    if(errWindow){
+      CountErr(e);
+      return frame;
+    }
+    p = BinOpen(frame, payload->srcAddr, BinError, payload);
+    *p++ = (CPU_INT08U) e;
+    return BinClose(frame, p);
+  }
+  // Types without a binary layout send their text reply
+  if(h->bin == NULL){
+    p = BinOpen(frame, payload->srcAddr, BinText, payload);
+    return BinClose(frame, (CPU_INT08U *) h->text(payload, (CPU_CHAR *) p));
+  }
+  
+  p = BinOpen(frame, payload->srcAddr, payload->msgType, payload);
+  p = h->bin(payload, p);
+  
+  return BinClose(frame, p);
+}
+
+/*--------------- B i n O p e n ---------------
+Write the preamble and body header of a binary reply, and the receive time
+of payload if time stamps are on. Return where the data goes.
+*/
+CPU_INT08U *BinOpen(CPU_INT08U frame[], CPU_INT08U src, CPU_INT08U type,
+                    Payload *payload){
+  CPU_INT08U *p = frame;
+  
+  *p++ = Preamble1;
+  *p++ = Preamble2;
+  *p++ = Preamble3;
+  p++;                          // Length is filled in by BinClose
+  *p++ = BinHost;
+  *p++ = src;
+  if(timestamps && payload != NULL){
+    *p++ = type | BinStamped;
+    p = BinPut32(p, (CPU_INT32U) RxTimeUs(payload));
+  }else{
+    *p++ = type;
+  }
+  
+  return p;
+}
+
+/*--------------- B i n C l o s e ---------------
+Fill in the length of a binary reply whose data ends at end, add the
+checksum or CRC and return the end of the frame
+*/
+CPU_INT08U *BinClose(CPU_INT08U frame[], CPU_INT08U *end){
+  CPU_INT16U chk;
+  
+  frame[HeaderLength - 1] = end - frame + TrailerLength;
+  chk = ChkRun(ChkInit, frame, end - frame);
+#if FrameCrc
+  *end++ = chk >> 8;
+#endif
+  *end++ = chk;
+  
+  return end;
+}
+
+/*--------------- B i n P u t 1 6 ---------------
+Write v little endian at p and return the next free byte
+*/
+CPU_INT08U *BinPut16(CPU_INT08U *p, CPU_INT16U v){
+  EndianPut16LE(p, v);
+  
+  return p + sizeof(v);
+}
+
+/*--------------- B i n P u t 3 2 ---------------
+Write v little endian at p and return the next free byte
+*/
+CPU_INT08U *BinPut32(CPU_INT08U *p, CPU_INT32U v){
+  EndianPut32LE(p, v);
+  
+  return p + sizeof(v);
+}
+
+/*--------------- L i n e R e p l y ---------------
+Write a reading as one CSV or JSON line, and return its end. A CSV line is
+  us,src,type,key=value,...
+and a JSON line holds the same fields:
+  {"ts":us,"src":src,"type":"type","key":value,...}
+us is the receive time in microseconds since start up. Counted errors get
+no reply, so the end is reply itself.
+*/
+CPU_CHAR *LineReply(Payload *payload, CPU_CHAR reply[]){
+  CPU_INT64U us = RxTimeUs(payload);
+  const MsgHandler *h;
+  CPU_CHAR *p;
+  Error_t e;
+  
+  if(payload->status < 0){
+    if(errWindow){
+      CountErr((Error_t) payload->status);
+      return reply;
+    }
+    p = LineOpen(reply, us, 0, "error");
+    p = FmtSDec(LineKey(p, "err"), payload->status);
+    return LineClose(p);
+  }
+  if(!AddrMapHas(payload->dstAddr)){
+    p = LineOpen(reply, us, payload->srcAddr, "info");
+    p = FmtUDec(LineKey(p, "dst"), payload->dstAddr);
+    return LineClose(p);
+  }
+  if((h = FindHandler(payload, &e)) == NULL){
+    if(errWindow){
+      CountErr(e);
+      return reply;
+    }
+    p = LineOpen(reply, us, payload->srcAddr, "error");
+    p = FmtSDec(LineKey(p, "err"), e);
+    p = FmtUDec(LineKey(p, "msgtype"), payload->msgType);
+    return LineClose(p);
+  }
+  
+  p = LineOpen(reply, us, payload->srcAddr, h->name);
+  if(h->line != NULL){
+    p = h->line(payload, p);
+  }else{
+    // Types without fields send their text reply as one. It is built past
+    // the end of the line, then copied back into it as the value.
+    p = LineKey(p, "text");
+    h->text(payload, p + 1);
+    p = LineText(p, p + 1);
+  }
+  
+  return LineClose(p);
+}
+
+/*--------------- L i n e O p e n ---------------
+Start a CSV or JSON line with the time, source and type fields
+*/
+CPU_CHAR *LineOpen(CPU_CHAR *p, CPU_INT64U us, CPU_INT08U src,
+                   const CPU_CHAR *type){
+  if(replyFormat == FMT_JSON){
+    p = FmtUDec64(FmtStr(p, "{\"ts\":"), us);
+    p = FmtUDec(FmtStr(p, ",\"src\":"), src);
+    p = FmtStr(FmtStr(FmtStr(p, ",\"type\":\""), type), "\"");
+  }else{
+    p = FmtUDec64(p, us);
+    p = FmtUDec(FmtStr(p, ","), src);
+    p = FmtStr(FmtStr(p, ","), type);
+  }
+  
+  return p;
+}
+
+/*--------------- L i n e K e y ---------------
+Start the next field of a line. Its value goes at the pointer returned.
+*/
+CPU_CHAR *LineKey(CPU_CHAR *p, const CPU_CHAR *key){
+  if(replyFormat == FMT_JSON)
+    return FmtStr(FmtStr(FmtStr(p, ",\""), key), "\":");
+  
+  return FmtStr(FmtStr(FmtStr(p, ","), key), "=");
+}
+
+/*--------------- L i n e S t r ---------------
+Append at most n characters of s as a string value, stopping early at a
+terminator. Characters that would end the field, and anything outside
+printable ASCII, are replaced with '?'. JSON strings are quoted.
+*/
+CPU_CHAR *LineStr(CPU_CHAR *p, const CPU_CHAR *s, CPU_INT16U n){
+  CPU_BOOLEAN json = (replyFormat == FMT_JSON);
+  CPU_INT08U c;
+  
+  if(json)
+    *p++ = '"';
+  while(n-- && (c = (CPU_INT08U) *s++) != '\0'){
+    if(c < ' ' || c > '~' || c == (json ? '"' : ',') ||
+       (json && c == '\\'))
+      c = '?';
+    *p++ = c;
+  }
+  if(json)
+    *p++ = '"';
+  *p = '\0';
+  
+  return p;
+}
+
+/*--------------- L i n e T e x t ---------------
+Append the text reply at text as a string value, leaving out its line
+breaks and other control characters. text may start just past p, as the
+copy never gets ahead of it.
+*/
+CPU_CHAR *LineText(CPU_CHAR *p, const CPU_CHAR *text){
+  CPU_BOOLEAN json = (replyFormat == FMT_JSON);
+  CPU_CHAR c;
+  
+  if(json)
+    *p++ = '"';
+  while((c = *text++) != '\0'){
+    if(c >= ' ' && c != (json ? '"' : ',') && !(json && c == '\\'))
+      *p++ = c;
+  }
+  if(json)
+    *p++ = '"';
+  *p = '\0';
+  
+  return p;
+}
+
+/*--------------- L i n e C l o s e ---------------
+End a CSV or JSON line
+*/
+CPU_CHAR *LineClose(CPU_CHAR *p){
+  if(replyFormat == FMT_JSON)
+    *p++ = '}';
+  
+  return FmtStr(p, "\n");
+}
+
+/*--------------- B i n F i e l d s ---------------
+Write the data of a binary reply to a reading of message m: each numeric
+field little endian in its binary width, and strings as they came
+*/
+CPU_INT08U *BinFields(const MsgDef *m, Payload *payload, CPU_INT08U *p){
+  const MsgField *f;
+  CPU_INT08U n;
+  CPU_INT08U i;
+  
+  for(i = 0; i < m->numFields; i++){
+    f = &m->fields[i];
+    if(f->kind == FLD_STR){
+      n = payload->payloadLen - MinBodyLength - f->offset;
+      memcpy(p, payload->data + f->offset, n);
+      p += n;
+    }else if(MsgWidth(f) == 1){
+      *p++ = MsgValue(f, payload->data);
     }else{
-      replyDone = SendReply(reply);
-      pState = replyDone ? P : R;
+      p = BinPut16(p, MsgValue(f, payload->data));
+    }
+  }
+  
+  return p;
+}
+
+/*--------------- L i n e F i e l d s ---------------
+Write the fields of a CSV or JSON line to a reading of message m. BCD
+fields are written with their decimal places.
+*/
+CPU_CHAR *LineFields(const MsgDef *m, Payload *payload, CPU_CHAR *p){
+  const MsgField *f;
+  CPU_INT08U i;
+  
+  for(i = 0; i < m->numFields; i++){
+    f = &m->fields[i];
+    p = LineKey(p, f->key);
+    switch(f->kind){
+      case(FLD_STR):
+        p = LineStr(p, (const CPU_CHAR *) payload->data + f->offset,
+                    payload->payloadLen - MinBodyLength - f->offset);
+        break;
+      case(FLD_S8):
+        p = FmtSDec(p, MsgValue(f, payload->data));
+        break;
+      case(FLD_BCD):
+        p = FmtFixed(p, MsgValue(f, payload->data), f->b);
+        break;
+      default:
+        p = FmtUDec(p, MsgValue(f, payload->data));
+        break;
     }
   }
+  
+  return p;
 }
 
-/* Parse and print each message in its own function */
+/* Parse and print each message in its own function. Each returns the end
+   of its reply. */
 
 /*--------------- P a r s e T e m p ---------------
 Generate a temperate message
 */
-void ParseTemp(Payload *payload, CPU_CHAR reply[]){
-  sprintf(reply, "\nSOURCE NODE %d: TEMPERATURE MESSAGE\n  Temperature = %d\n\0",
-          payload->srcAddr,
-          
-          payload->dataPart.temp);
+CPU_CHAR *ParseTemp(Payload *payload, CPU_CHAR reply[]){
+  CPU_CHAR *p = FmtStr(reply, "\nSOURCE NODE ");
+  
+  p = FmtUDec(p, payload->srcAddr);
+  p = FmtStr(p, ": TEMPERATURE MESSAGE\n  Temperature = ");
+  p = FmtSDec(p, GetTempTemp(payload->data));
+  return FmtStr(p, "\n");
 }
 
 /*--------------- P a r s e P r e s s u r e ---------------
 Generate a pressure message
 */
-void ParsePressure(Payload *payload, CPU_CHAR reply[]){
-  sprintf(reply, "\nSOURCE NODE %d: BAROMETRIC PRESSURE MESSAGE\n  Pressure = %d\n\0",
-          payload->srcAddr,
-          
-          Reverse2Bytes(payload->dataPart.pres));
+CPU_CHAR *ParsePressure(Payload *payload, CPU_CHAR reply[]){
+  CPU_CHAR *p = FmtStr(reply, "\nSOURCE NODE ");
+  
+  p = FmtUDec(p, payload->srcAddr);
+  p = FmtStr(p, ": BAROMETRIC PRESSURE MESSAGE\n  Pressure = ");
+  p = FmtUDec(p, GetPressurePres(payload->data));
+  return FmtStr(p, "\n");
 }
 
 /*--------------- P a r s e H u m i d i t y ---------------
 Generate a humidity message
 */
-void ParseHumidity(Payload *payload, CPU_CHAR reply[]){
-  sprintf(reply, "\nSOURCE NODE %d: HUMIDITY MESSAGE\n  Dew Point = %d Humidity = %u\n\0",
-          payload->srcAddr,
-          
-          payload->dataPart.hum.dewPt,payload->dataPart.hum.hum);
+CPU_CHAR *ParseHumidity(Payload *payload, CPU_CHAR reply[]){
+  CPU_CHAR *p = FmtStr(reply, "\nSOURCE NODE ");
+  
+  p = FmtUDec(p, payload->srcAddr);
+  p = FmtStr(p, ": HUMIDITY MESSAGE\n  Dew Point = ");
+  p = FmtSDec(p, GetHumidityDewPt(payload->data));
+  p = FmtStr(p, " Humidity = ");
+  p = FmtUDec(p, GetHumidityHum(payload->data));
+  return FmtStr(p, "\n");
 }
 
 /*--------------- P a r s e W i n d ---------------
 Generate a wind message
 */
-void ParseWind(Payload *payload, CPU_CHAR reply[]){
-  sprintf(reply, "\nSOURCE NODE %d: WIND MESSAGE\n  Speed = %d%d%d.%d Wind Direction = %d\n\0",
-          payload->srcAddr,
-         
-          (payload->dataPart.wind.speed[LowByte] >> Nibble),
-          (payload->dataPart.wind.speed[LowByte] & LowNibble),
-          (payload->dataPart.wind.speed[HighByte] >> Nibble),
-          (payload->dataPart.wind.speed[HighByte] & LowNibble),
-         
-          Reverse2Bytes(payload->dataPart.wind.dir));
+CPU_CHAR *ParseWind(Payload *payload, CPU_CHAR reply[]){
+  CPU_CHAR *p = FmtStr(reply, "\nSOURCE NODE ");
+  
+  p = FmtUDec(p, payload->srcAddr);
+  p = FmtStr(p, ": WIND MESSAGE\n  Speed = ");
+  p = FmtBcd(p, payload->data + WindSpeedOffset, WindSpeedDigits, 
+             WindSpeedDigits - WindSpeedPlaces);
+  p = FmtStr(p, " Wind Direction = ");
+  p = FmtUDec(p, GetWindDir(payload->data));
+  return FmtStr(p, "\n");
 }
 
 /*--------------- P a r s e R a d i a t i o n ---------------
 Generate a radiation message
 */
-void ParseRadiation(Payload *payload, CPU_CHAR reply[]){
-  sprintf(reply, "\nSOURCE NODE %d: SOLAR RADIATION MESSAGE\n  Solar Radiation Intensity = %u\n\0",
-          payload->srcAddr,
-         
-          Reverse2Bytes(payload->dataPart.rad));
+CPU_CHAR *ParseRadiation(Payload *payload, CPU_CHAR reply[]){
+  CPU_CHAR *p = FmtStr(reply, "\nSOURCE NODE ");
+  
+  p = FmtUDec(p, payload->srcAddr);
+  p = FmtStr(p, ": SOLAR RADIATION MESSAGE\n  Solar Radiation Intensity = ");
+  p = FmtUDec(p, GetRadiationRad(payload->data));
+  return FmtStr(p, "\n");
 }
 
 /*--------------- P a r s e T i m e S t a m p ---------------
 Generate a time/date message
 */
-void ParseTimeStamp(Payload *payload, CPU_CHAR reply[]){
-  /* Starting bit and bitmask for each component of packed date/time message */
-  const CPU_INT08U DayPosition    = 0;
-  const CPU_INT08U MonthPosition  = 5;
-  const CPU_INT08U YearPosition   = 9;
-  const CPU_INT08U MinutePosition = 21;
-  const CPU_INT08U HourPosition   = 27;
-  
-  const CPU_INT08U DayMask        = 0x1F;
-  const CPU_INT08U MonthMask      = 0xF;
-  const CPU_INT16U YearMask       = 0xFFF;
-  const CPU_INT08U MinuteMask     = 0x3F;
-  const CPU_INT08U HourMask       = 0x1F;
+CPU_CHAR *ParseTimeStamp(Payload *payload, CPU_CHAR reply[]){
+  CPU_CHAR *p = FmtStr(reply, "\nSOURCE NODE ");
   
-  CPU_INT32U packDate = Reverse4Bytes(payload->dataPart.dateTime);
-  
-  sprintf(reply, "\nSOURCE NODE %d: DATE/TIME STAMP MESSAGE\n  Time Stamp = %d/%d/%d %d:%d\n\0",
-          payload->srcAddr,
-          
-          packDate>>MonthPosition  & MonthMask,
-          packDate>>DayPosition    & DayMask,
-          packDate>>YearPosition   & YearMask,
-          packDate>>HourPosition   & HourMask,
-          packDate>>MinutePosition & MinuteMask);
+  p = FmtUDec(p, payload->srcAddr);
+  p = FmtStr(p, ": DATE/TIME STAMP MESSAGE\n  Time Stamp = ");
+  p = FmtUDec(p, GetTimeStampMonth(payload->data));
+  p = FmtStr(p, "/");
+  p = FmtUDec(p, GetTimeStampDay(payload->data));
+  p = FmtStr(p, "/");
+  p = FmtUDec(p, GetTimeStampYear(payload->data));
+  p = FmtStr(p, " ");
+  p = FmtUDec(p, GetTimeStampHour(payload->data));
+  p = FmtStr(p, ":");
+  p = FmtUDec(p, GetTimeStampMin(payload->data));
+  return FmtStr(p, "\n");
 }
 
 /*--------------- P a r s e P r e c i p ---------------
 Generate a precipitation message
 */
-void ParsePrecip(Payload *payload, CPU_CHAR reply[]){
-  sprintf(reply, "\nSOURCE NODE %d: PRECIPITATION MESSAGE\n  Precipitation Depth = %d%d.%d%d\n\0",
-          payload->srcAddr,
-          
-          (payload->dataPart.wind.speed[LowByte] >> Nibble),
-          (payload->dataPart.wind.speed[LowByte] & LowNibble),
-          (payload->dataPart.wind.speed[HighByte] >> Nibble),
-          (payload->dataPart.wind.speed[HighByte] & LowNibble));
+CPU_CHAR *ParsePrecip(Payload *payload, CPU_CHAR reply[]){
+  CPU_CHAR *p = FmtStr(reply, "\nSOURCE NODE ");
+  
+  p = FmtUDec(p, payload->srcAddr);
+  p = FmtStr(p, ": PRECIPITATION MESSAGE\n  Precipitation Depth = ");
+  p = FmtBcd(p, payload->data + PrecipDepthOffset, PrecipDigits, 
+             PrecipDigits - PrecipPlaces);
+  return FmtStr(p, "\n");
 }
 
 /*--------------- P a r s e I D ---------------
 Generate an ID message
 */
-void ParseID(Payload *payload, CPU_CHAR reply[]){
-  sprintf(reply, "\nSOURCE NODE %d: SENSOR ID MESSAGE\n  Node ID = %s\n\0",
-          payload->srcAddr,
-          payload->dataPart.id);
+CPU_CHAR *ParseID(Payload *payload, CPU_CHAR reply[]){
+  CPU_CHAR *p = FmtStr(reply, "\nSOURCE NODE ");
+  
+  p = FmtUDec(p, payload->srcAddr);
+  p = FmtStr(p, ": SENSOR ID MESSAGE\n  Node ID = ");
+  // The ID is not terminated in the packet, so bound it by the body length
+  p = FmtChars(p, GetIDId(payload->data), 
+               payload->payloadLen - MinBodyLength);
+  return FmtStr(p, "\n");
 }
 
-/*--------------- S e n d R e p l y ---------------
-Send the reply message one byte at a time.
-If the entire message has been sent, return true
+/*--------------- P a r s e D i a g ---------------
+Generate the reply to a diagnostic command
 */
-CPU_BOOLEAN SendReply(CPU_CHAR reply[]){
-  static CPU_INT08S j = 0;
-  CPU_BOOLEAN retVal = FALSE;
+CPU_CHAR *ParseDiag(Payload *payload, CPU_CHAR reply[]){
+  // A missing argument reads as 0
+  CPU_INT08U arg = (payload->payloadLen > MinBodyLength + 1) ? 
+                   payload->data[DiagArgOffset] : 0;
+  CPU_CHAR *p;
+  
+  switch(payload->data[DiagCmdOffset]){
+    case(DIAG_LATENCY):
+#if LATENCY_HIST
+      p = LatHistReport(arg, reply);
+#else
+      p = FmtStr(reply, "\nDIAGNOSTIC: Latency histograms not built\n");
+#endif
+      break;
+    case(DIAG_STATS):
+      p = DiagStats(reply);
+      break;
+    case(DIAG_TYPE):
+      p = FmtStr(reply, "\nDIAGNOSTIC: Type ");
+      p = FmtUDec(p, arg);
+      p = FmtStr(p, " frames = ");
+      p = FmtUDec(p, ParserGetStats()->byType[arg]);
+      p = FmtStr(p, "\n");
+      break;
+    case(DIAG_SOURCE):
+      p = FmtStr(reply, "\nDIAGNOSTIC: Node ");
+      p = FmtUDec(p, arg);
+      p = FmtStr(p, " frames = ");
+      p = FmtUDec(p, ParserGetStats()->bySource[arg]);
+      p = FmtStr(p, " dropped = ");
+      p = FmtUDec(p, ParserGetStats()->dropped[arg]);
+      p = FmtStr(p, "\n");
+      break;
+    case(DIAG_FORMAT):
+      if(arg < NumFormats)
+        PayloadSetFormat((ReplyFormat_t) arg);
+      // Replies after this one are in the new format
+      p = FmtStr(reply, "\nDIAGNOSTIC: Format = ");
+      p = FmtUDec(p, newFormat);
+      p = FmtStr(p, "\n");
+      break;
+    case(DIAG_REPLYQ):
+      if(payload->payloadLen > MinBodyLength + 1 && arg < NumDropPolicies)
+        ReplyQSetPolicy((ReplyDrop_t) arg);
+      p = FmtStr(reply, "\nDIAGNOSTIC: Replies queued = ");
+      p = FmtUDec(p, ReplyQDepth());
+      p = FmtStr(p, " dropped = ");
+      p = FmtUDec(p, ReplyQDropped());
+      p = FmtStr(p, "\n");
+      break;
+    case(DIAG_TXCLASS):
+      p = DiagTxClass((arg < NumPrios) ? (ReplyPrio_t) arg : PRIO_LOW, reply);
+      break;
+    case(DIAG_NODE):
+      p = DiagNode(arg, (payload->payloadLen > MinBodyLength + 2) ? 
+                        payload->data[DiagTypeOffset] : 0, reply);
+      break;
+    default:
+      p = FmtStr(reply, "\nDIAGNOSTIC: Unknown command ");
+      p = FmtUDec(p, payload->data[DiagCmdOffset]);
+      p = FmtStr(p, "\n");
+      break;
+  }
+  
+  return p;
+}
+
+/*--------------- D i a g S t a t s ---------------
+Generate the parser statistics summary. The frame rate is taken over the
+time since the last summary.
+*/
+CPU_CHAR *DiagStats(CPU_CHAR reply[]){
+  static CPU_INT32U lastFrames = 0;
+  static OS_TICK lastTick = 0;
+  const volatile ParserStats *st = ParserGetStats();
+  CPU_INT32U frames = st->goodFrames;
+  OS_TICK now;
+  OS_TICK ticks;
+  CPU_INT32U rate = 0;            // Tenths of a frame per second
+  CPU_CHAR *p;
+  OS_ERR osErr;
+  
+  now = OSTimeGet(&osErr);
+  ticks = now - lastTick;
+  if(ticks > 0)
+    rate = (CPU_INT64U) (frames - lastFrames) * Tenths * OSCfg_TickRate_Hz / 
+           ticks;
+  lastFrames = frames;
+  lastTick = now;
+  
+  p = FmtStr(reply, "\nSTATS: ");
+  p = FmtUDec(p, rate / Tenths);
+  p = FmtStr(p, ".");
+  p = FmtUDec(p, rate % Tenths);
+  p = FmtStr(p, " fps good=");
+  p = FmtUDec(p, frames);
+  p = FmtStr(p, " skip=");
+  p = FmtUDec(p, st->bytesSkipped);
+  p = FmtStr(p, " pre=");
+  p = FmtUDec(p, st->errors[-ERR_PREAMBLE_1]);
+  p = FmtStr(p, "/");
+  p = FmtUDec(p, st->errors[-ERR_PREAMBLE_2]);
+  p = FmtStr(p, "/");
+  p = FmtUDec(p, st->errors[-ERR_PREAMBLE_3]);
+  p = FmtStr(p, " chk=");
+  p = FmtUDec(p, st->errors[-ERR_CHECKSUM]);
+  p = FmtStr(p, " len=");
+  p = FmtUDec(p, st->errors[-ERR_LEN]);
+  return FmtStr(p, "\n");
+}
+
+/*--------------- D i a g T x C l a s s ---------------
+Write what became of the replies of one priority class, with their mean
+and longest wait in the reply queue.
+*/
+CPU_CHAR *DiagTxClass(ReplyPrio_t prio, CPU_CHAR reply[]){
+  const ReplyClassStats *s = ReplyQStats(prio);
+  CPU_CHAR *p;
+  
+  p = FmtStr(reply, "\nDIAGNOSTIC: Class ");
+  p = FmtUDec(p, prio);
+  p = FmtStr(p, " sent=");
+  p = FmtUDec(p, s->sent);
+  p = FmtStr(p, " dropped=");
+  p = FmtUDec(p, s->dropped);
+  p = FmtStr(p, " coalesced=");
+  p = FmtUDec(p, s->coalesced);
+  p = FmtStr(p, " wait mean=");
+  p = FmtUDec(p, (s->sent > 0) ? (CPU_INT32U) (s->totalUs / s->sent) : 0);
+  p = FmtStr(p, " max=");
+  p = FmtUDec(p, s->maxUs);
+  return FmtStr(p, " us\n");
+}
+
+/*--------------- D i a g N o d e ---------------
+Write the latest reading of msgType from node src, how many have come and
+how long ago the latest was received, in milliseconds up to 49 days.
+Type 0 lists the types src has sent, of those with fixed fields.
+*/
+CPU_CHAR *DiagNode(CPU_INT08U src, CPU_INT08U msgType, CPU_CHAR reply[]){
+  const MsgDef *m;
+  const MsgField *f;
+  NodeReading r;
+  CPU_INT16U type;
+  CPU_INT08U i;
+  CPU_CHAR *p;
+  
+  p = FmtStr(reply, "\nNODE ");
+  p = FmtUDec(p, src);
+  if(msgType == 0){
+    p = FmtStr(p, " has:");
+    for(type = 1; type < NumMsgTypes; type++){
+      if((m = NodeCacheDef(type)) != NULL && NodeCacheRead(src, type, &r)){
+        p = FmtStr(p, " ");
+        p = FmtStr(p, m->key);
+      }
+    }
+    return FmtStr(p, "\n");
+  }
+  
+  m = NodeCacheDef(msgType);
+  if(m == NULL || !NodeCacheRead(src, msgType, &r)){
+    p = FmtStr(p, " no reading of type ");
+    p = FmtUDec(p, msgType);
+    return FmtStr(p, "\n");
+  }
+  p = FmtStr(p, " ");
+  p = FmtStr(p, m->key);
+  p = FmtStr(p, ":");
+  for(i = 0; i < m->numFields; i++){
+    f = &m->fields[i];
+    if(f->kind == FLD_STR)
+      continue;
+    p = FmtStr(p, " ");
+    p = FmtStr(p, f->key);
+    p = FmtStr(p, "=");
+    if(f->kind == FLD_S8)
+      p = FmtSDec(p, MsgValue(f, r.data));
+    else if(f->kind == FLD_BCD)
+      p = FmtFixed(p, MsgValue(f, r.data), f->b);
+    else
+      p = FmtUDec(p, MsgValue(f, r.data));
+  }
+  p = FmtStr(p, " updates=");
+  p = FmtUDec(p, r.count);
+  p = FmtStr(p, " age=");
+  p = FmtUDec(p, (CPU_INT32U) (ClockNowUs() / UsPerMs) - r.rxMs);
+  return FmtStr(p, " ms\n");
+}
+
+/*--------------- C o u n t E r r ---------------
+Count an error toward the next summary, starting a window if none is open
+*/
+void CountErr(Error_t e){
+  OS_ERR osErr;
+  
+  if(!errPending){
+    errPending = TRUE;
+    errStart = OSTimeGet(&osErr);
+  }
+  errCount[-e]++;
+}
+
+/*--------------- E r r S u m m a r y D u e ---------------
+Return true if errors have been counted for a whole window. Otherwise set
+wait to the ticks left in the window, or 0 if no errors are waiting.
+*/
+CPU_BOOLEAN ErrSummaryDue(OS_TICK *wait){
+  OS_TICK window = errWindow * OSCfg_TickRate_Hz;
+  OS_TICK age;
+  OS_ERR osErr;
+  
+  *wait = 0;
+  if(!errPending)
+    return FALSE;
+  
+  age = OSTimeGet(&osErr) - errStart;
+  if(age >= window)
+    return TRUE;
+  
+  *wait = window - age;
+  return FALSE;
+}
 
-  if(j<strlen(reply)){
-    PutByte(reply[j]);
-    j++;
+/*--------------- E r r S u m m a r y ---------------
+Generate one line reporting the errors counted in the window, then start
+counting again
+*/
+CPU_CHAR *ErrSummary(CPU_CHAR reply[]){
+  OS_ERR osErr;
+  CPU_INT32U preamble = errCount[-ERR_PREAMBLE_1] + 
+                        errCount[-ERR_PREAMBLE_2] +
+                        errCount[-ERR_PREAMBLE_3];
+  CPU_INT32U secs = (OSTimeGet(&osErr) - errStart) / OSCfg_TickRate_Hz;
+  CPU_CHAR *p = reply;
+  CPU_INT08U i;
+  
+  if(replyFormat == FMT_CSV || replyFormat == FMT_JSON){
+    p = LineOpen(p, ClockNowUs(), 0, "errors");
+    p = FmtUDec(LineKey(p, "preamble"), preamble);
+    p = FmtUDec(LineKey(p, "checksum"), errCount[-ERR_CHECKSUM]);
+    p = FmtUDec(LineKey(p, "length"), errCount[-ERR_LEN]);
+    p = FmtUDec(LineKey(p, "type"), errCount[-ERR_MSG_TYPE]);
+    p = FmtUDec(LineKey(p, "secs"), secs);
+    p = LineClose(p);
   }else{
-    j = 0;
-    retVal = TRUE;
+    p = ErrSummaryText(p, preamble, secs);
+  }
+  
+  for(i = 0; i < NumErrors; i++)
+    errCount[i] = 0;
+  errPending = FALSE;
+  
+  return p;
+}
+
+/*--------------- E r r S u m m a r y T e x t ---------------
+Generate the text summary line of preamble errors and the other counts
+taken over secs seconds
+*/
+CPU_CHAR *ErrSummaryText(CPU_CHAR reply[], CPU_INT32U preamble,
+                         CPU_INT32U secs){
+  CPU_CHAR *p = FmtStr(reply, "\a*** ERRORS:");
+  
+  if(preamble){
+    p = FmtStr(FmtUDec(FmtStr(p, " "), preamble), " preamble,");
+  }
+  if(errCount[-ERR_CHECKSUM]){
+    p = FmtStr(FmtUDec(FmtStr(p, " "), errCount[-ERR_CHECKSUM]), " checksum,");
   }
+  if(errCount[-ERR_LEN]){
+    p = FmtStr(FmtUDec(FmtStr(p, " "), errCount[-ERR_LEN]), " length,");
+  }
+  if(errCount[-ERR_MSG_TYPE]){
+    p = FmtStr(FmtUDec(FmtStr(p, " "), errCount[-ERR_MSG_TYPE]), " type,");
+  }
+  // Replace the last comma
+  p = FmtStr(p - 1, " in last ");
+  p = FmtUDec(p, secs);
   
-  return retVal;
+  return FmtStr(p, " s\n");
 }
 
-// Byte reversal functions for 1 and 2 word ints
-/*--------------- R e v e r s e 2 B y t e s ---------------
-Byte reversal of a 2-byte int
+/*--------------- R x T i m e U s ---------------
+Return the time the packet was received, in microseconds since start up
 */
-CPU_INT16U Reverse2Bytes(CPU_INT16U b){
-  b = (b<<8) | (b>>8);
-  return b;
+CPU_INT64U RxTimeUs(Payload *payload){
+  return ClockUs(payload->rxTs);
 }
 
-/*--------------- R e v e r s e 4 B y t e s ---------------
-Byte reversal of a 4-byte int
+/*--------------- A d d R x T i m e ---------------
+Add the time the packet was received, in microseconds since start up, at
+the end p of a reply
 */
-CPU_INT32U Reverse4Bytes(CPU_INT32U b){
-  b = (b<<24) | ((b<<8)&0xFF0000) | ((b>>8)&0xFF00) | (b>>24);
-  return b;
-}
\ No newline at end of file
+CPU_CHAR *AddRxTime(Payload *payload, CPU_CHAR *p){
+  p = FmtStr(p, "  Received at ");
+  p = FmtUDec64(p, RxTimeUs(payload));
+  return FmtStr(p, " us\n");
+}
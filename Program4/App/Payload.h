@@ -8,17 +8,93 @@ Parse payload and handle response
 CHANGES
 02-19-2014 mn -  Initial submission
 03-12-2014 mn -  Updated to use uCOS-III and semaphores
+10-19-2026 mn -  Payload buffers hold the longest packet the length byte allows
+10-19-2026 mn -  Payload buffers hold a queue of records
+10-19-2026 mn -  MyAddress moved here for the parser's address filter
+10-19-2026 mn -  Receive time stamp in each record
+10-19-2026 mn -  Added the error window setting
+10-19-2026 mn -  Added the reply format setting
+10-19-2026 mn -  Added the CSV and JSON lines formats
+10-19-2026 mn -  Payload layout moved here, message type handler registration
+10-19-2026 mn -  Data part laid out by the message lists in MsgDefs.h
+10-19-2026 mn -  Record header length follows the size of CPU_TS
 */
 
 #ifndef PAYLOAD_H
 #define PAYLOAD_H
 
 #include "BfrPair.h" // Needed for payloadBfrPair
+#include "FrameChk.h"
+#include "MsgDefs.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define MyAddress 1              /* Local address at start up, see AddrMap */
+
+/* A payload buffer record is a status byte, 0 or an Error_t, the body
+   length, the CPU_TS time the preamble was received, then the body.
+   Records are sized from the length byte and packed one after another, so
+   a buffer holds many short records or at least one with the longest body
+   a packet can carry. */
+#define PayloadHdrLength (2 + sizeof(CPU_TS))   /* Status, length, time */
+#define MaxBodyLength (MaxFrameLen - HeaderLength - TrailerLength)
+
+#ifndef PayloadBfrSize
+#define PayloadBfrSize 512
+#endif
+
+/* PayloadBfrSize must hold the longest record. sizeof cannot be used in
+   #if, so the array size goes negative instead if it does not. */
+typedef CPU_INT08U PayloadBfrFits[(PayloadBfrSize >= PayloadHdrLength +
+                                   MaxBodyLength) ? 1 : -1];
+
+/* Reply formats. Binary replies are laid out in BinReply.h. CSV and JSON
+   replies are one line per reading, see LineReply in Payload.c. */
+typedef enum {FMT_TEXT, FMT_BINARY, FMT_CSV, FMT_JSON,
+              NumFormats} ReplyFormat_t;
+
+#ifndef ReplyFormat
+#define ReplyFormat FMT_TEXT
+#endif
+
+#define NumMsgTypes 256         /* Every value of the type byte */
+
+/*----- t y p e d e f s   u s e d   i n   p a y l o a d   m o d u l e -----*/
+#pragma pack(push, 1)
+typedef struct
+{
+  CPU_INT08S    status;         // 0 or an Error_t
+  CPU_INT08U    payloadLen;     // Body bytes from dstAddr on
+  CPU_TS        rxTs;           // Time the preamble was received
+  CPU_INT08U    dstAddr;
+  CPU_INT08U    srcAddr;
+  CPU_INT08U    msgType;
+  CPU_INT08U    data[MaxBodyLength - MinBodyLength]; // See MsgDefs.h
+} Payload;
+#pragma pack(pop)
+
+/* Replies to one message type. Each formatter writes at p and returns the
+   end of what it wrote. The payload task checks the body length against
+   minLen and maxLen before calling any of them. */
+typedef struct
+{
+  CPU_INT08U minLen;            // Body bytes from dstAddr on
+  CPU_INT08U maxLen;
+  const CPU_CHAR *name;         // Type field of CSV and JSON lines
+  CPU_CHAR *(*text)(Payload *payload, CPU_CHAR *p);     // Whole text reply
+  CPU_INT08U *(*bin)(Payload *payload, CPU_INT08U *p);  // Binary data, or
+                                                        // NULL to send text
+  CPU_CHAR *(*line)(Payload *payload, CPU_CHAR *p);     // Line fields, or
+                                                        // NULL to send text
+} MsgHandler;
 
 // Allow payloadBfrPair to be used by PktParser
 extern BfrPair payloadBfrPair;
 
 /*----- f u n c t i o n    p r o t o t y p e s -----*/
 void CreatePayloadTask(void);
+void PayloadSetTimestamps(CPU_BOOLEAN on);
+void PayloadSetErrWindow(CPU_INT16U seconds);
+void PayloadSetFormat(ReplyFormat_t format);
+void PayloadRegister(CPU_INT08U msgType, const MsgHandler *handler);
 
 #endif
\ No newline at end of file
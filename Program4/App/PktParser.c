@@ -6,31 +6,53 @@ PURPOSE
 Handles incoming packets for payload buffer to parse.
 Each state of the parsing state machine is implemented as a function that
 receives a struct with the current state information.
+Records are packed one after another into a payload buffer. The buffer is
+handed to the payload task when the task has nothing to do, when the next
+record will not fit, or when the input has been quiet for FLUSH_TIMEOUT.
+A packet's record is not started until its destination byte is seen.
+Unless promiscuous mode is on, a packet for another address gets no
+record, so it never takes buffer room or waits for a buffer. It is still
+checked, so a bad packet is reported whoever it was for.
 
 CHANGES
 02-19-2014 mn -  Initial Submission
 03-12-2014 mn -  Updated to use uCOS-III and semaphores
+10-19-2026 mn -  Parse whole input spans, take packet bodies as a block
+10-19-2026 mn -  Integrity check selected by FrameCrc
+10-19-2026 mn -  Validate packets in the input span before copying them
+10-19-2026 mn -  Status and body length header on payload records
+10-19-2026 mn -  Pack many records into each payload buffer
+10-19-2026 mn -  Drop packets for other addresses as their destination arrives
+10-19-2026 mn -  Local addresses come from AddrMap
+10-19-2026 mn -  Time stamp packets at the start of the preamble
+10-19-2026 mn -  Count frames, errors and skipped bytes
+10-19-2026 mn -  Records started once the destination is known
 */
 
 /* Include dependencies */
 #include "includes.h"
 #include "PktParser.h"
+#include "AddrMap.h"
 #include "assert.h"
 #include "BfrPair.h"
 #include "Error.h"
+#include "FrameChk.h"
 #include "Payload.h"
 #include "SerIODriver.h"
 
 /*----- c o n s t a n t    d e f i n i t i o n s -----*/
-#define HeaderLength 4 
-#define ShortestPacket 8
 #define NUM_BFRS 2
 #define SUSPEND_TIMEOUT 250
+#define FLUSH_TIMEOUT 10        /* Ticks of quiet input before a flush */
 #define PARSER_STK_SIZE 128
 #define ParserPrio 4
-#define PayloadBfrSize 14
 #define HIGH_WATER_LIMIT 10
 
+/* Body bytes ahead of the data */
+#define BodyDst 0
+#define BodySrc 1
+#define BodyType 2
+
 /*----- t y p e d e f s   u s e d   i n   p a r s e r -----*/
 /* Parser state data type */
 typedef enum { P, L, R, ER } ParserState;
@@ -39,13 +61,20 @@ typedef enum { P, L, R, ER } ParserState;
 typedef struct{
   ParserState parseState;
   CPU_INT16S c;  // Current byte
-  CPU_INT08U checkSum;
-  CPU_INT08S payloadLen;
+  CPU_INT16U checkSum;    // Running checksum or CRC, see FrameChk.h
+  CPU_INT16U payloadLen;  // Bytes of the packet still to be read
+  CPU_INT16U recordStart; // Payload buffer position of the current record
+  CPU_BOOLEAN filter;     // Destination not yet checked, no record yet
+  CPU_BOOLEAN skip;       // Packet is for another address
+  CPU_INT08U body[MinBodyLength]; // Destination, source and type
+  CPU_INT08U bodySeen;    // How much of body has been read
+  CPU_TS rxTs;            // Time the first preamble byte was received
   CPU_INT08U preamble[HeaderLength-1];
 } StateVariables_t;
 
 /* Packet structure */
 typedef struct{
+  CPU_INT08S status;
   CPU_INT08U payloadLen;
   CPU_INT08U data[1];
 } PktBfr;
@@ -55,16 +84,32 @@ typedef struct{
 OS_SEM openPayloadBfrs;
 OS_SEM closedPayloadBfrs;
 
+// TRUE while the parser holds an open payload buffer
+static CPU_BOOLEAN haveBfr = FALSE;
+
+// Pass packets for every address on to the payload task
+static volatile CPU_BOOLEAN promiscuous = FALSE;
+
+// Parser statistics
+static volatile ParserStats stats;
+
 static OS_TCB parsePktTCB;
 static CPU_STK parsePktStk[PARSER_STK_SIZE];
 
 /*----- l o c a l   f u n c t i o n    p r o t o t y p e s -----*/
 void DoStateP(StateVariables_t *myState);
 void DoStateL(StateVariables_t *myState);
-void DoStateR(StateVariables_t *myState);
+CPU_INT16U DoStateR(StateVariables_t *myState, CPU_INT08U *span,
+                    CPU_INT16U n);
 void DoStateER(StateVariables_t *myState);
-void ErrorTransition(StateVariables_t *myState);
-void ParsePkt(void *payloadBfrPair);
+void ErrorTransition(StateVariables_t *myState, Error_t e);
+void ReserveRecord(StateVariables_t *myState, CPU_INT16U n);
+void EndRecord(void);
+void FlushRecords(void);
+void PutRecordHdr(StateVariables_t *myState, Error_t status,
+                  CPU_INT08U len);
+void CountGood(StateVariables_t *myState);
+void ParsePkt(void *data);
 
 /*--------------- C r e a t e P a r s e P k t T a s k ---------------
 Start the packet parsing task and create the relevant semaphores
@@ -95,46 +140,101 @@ void CreateParsePktTask(void){
   assert(osErr == OS_ERR_NONE);
 }
 
+/*--------------- P a r s e r S e t P r o m i s c u o u s ---------------
+Turn promiscuous mode on or off. When on, packets for every address are 
+passed to the payload task as before. Takes effect from the next packet
+whose destination byte has not been read.
+*/
+void ParserSetPromiscuous(CPU_BOOLEAN on){
+  promiscuous = on;
+}
+
+/*--------------- P a r s e r D r o p C o u n t ---------------
+Return how many good packets for dstAddr the destination filter dropped
+*/
+CPU_INT32U ParserDropCount(CPU_INT08U dstAddr){
+  return stats.dropped[dstAddr];
+}
+
+/*--------------- P a r s e r G e t S t a t s ---------------
+Return the parser statistics
+*/
+const volatile ParserStats *ParserGetStats(void){
+  return &stats;
+}
+
 /*--------------- P a r s e P k t ---------------
 This is the main function used for packet parsing. It is implemented as a 
 state machine.
 */
-void ParsePkt(void *payloadBfrPair){
+void ParsePkt(void *data){
 
   static StateVariables_t myState = {.parseState = P,
                                      .c = 0,
-                                     .checkSum = 0,
+                                     .checkSum = ChkInit,
                                      .payloadLen = 0,
-                                     .preamble = {0x03, 0xEF, 0xAF}};
-  OS_ERR osErr;
+                                     .recordStart = 0,
+                                     .filter = FALSE,
+                                     .skip = FALSE,
+                                     .body = {0},
+                                     .bodySeen = 0,
+                                     .rxTs = 0,
+                                     .preamble = {Preamble1,
+                                                  Preamble2,
+                                                  Preamble3}};
+  CPU_INT08U *span;
+  CPU_INT16U n;
+  CPU_INT16U i;
+  CPU_TS spanTs;
+  CPU_TS byteTime = SerByteTime();
+  OS_TICK timeout;
 
   for(;;){
-    // GetByte will pend if there is no data ready.
-    myState.c = GetByte();
+    // Records waiting between packets are flushed if the input goes quiet
+    timeout = 0;
+    if(haveBfr && !PutBfrEmpty(&payloadBfrPair) &&
+       (myState.parseState == P || myState.parseState == ER))
+      timeout = FLUSH_TIMEOUT;
     
-    // Maintain running checksum as bytes are received
-    myState.checkSum ^= myState.c;
-  
-    switch (myState.parseState){
-      case P:  // Look for a preamble
-        DoStateP(&myState);
-        break;
-      case L: // Read in packet length
-        // Since this is the first time the payload buffer is written to
-        // and this state is only entered once, it makes sense to wait here
-        // for a payload buffer to open.
-        OSSemPend(&openPayloadBfrs, SUSPEND_TIMEOUT, OS_OPT_PEND_BLOCKING, NULL, &osErr);
-        assert(osErr==OS_ERR_NONE);
-        DoStateL(&myState);
-        break;
-      case R:   // Read in data
-        DoStateR(&myState);
-        break;
-      case ER:  // If an error occurs, or a an unknown state arises,
-      default:  // look for a  full preamble.
-        DoStateER(&myState);
-        break;
+    // GetSpan will pend if there is no data ready.
+    n = GetSpan(&span, &spanTs, timeout);
+    if(n == 0){
+      FlushRecords();
+      continue;
     }
+    
+    for(i = 0; i < n;){
+      // Packet bodies are taken a run at a time rather than byte by byte
+      if(myState.parseState == R){
+        i += DoStateR(&myState, &span[i], n - i);
+        continue;
+      }
+      
+      myState.c = span[i++];
+      
+      // Maintain running checksum as bytes are received
+      myState.checkSum = ChkByte(myState.checkSum, myState.c);
+      
+      // The last Preamble1 seen outside a packet starts the next one
+      if(myState.c == Preamble1 && myState.parseState != L)
+        myState.rxTs = spanTs + (CPU_TS) (i - 1) * byteTime;
+    
+      switch (myState.parseState){
+        case P:  // Look for a preamble
+          DoStateP(&myState);
+          break;
+        case L: // Read in packet length
+          DoStateL(&myState);
+          break;
+        case ER:  // If an error occurs, or a an unknown state arises,
+        default:  // look for a  full preamble.
+          DoStateER(&myState);
+          break;
+      }
+    }
+    
+    // Release the span back to the serial driver
+    SkipSpan(n);
   }
 }
 
@@ -144,15 +244,11 @@ If the wrong byte is found, it moves to the error state.
 */
 void DoStateP(StateVariables_t *myState){
   static CPU_INT08S pb = 0;
-  OS_ERR osErr;
   
   // If the wrong byte is found, go to error state
   if (myState->c != myState->preamble[pb++]){
-    OSSemPend(&openPayloadBfrs, SUSPEND_TIMEOUT, OS_OPT_PEND_BLOCKING, NULL, &osErr);
-    assert(osErr==OS_ERR_NONE);
     // Use preamble index that is currently being compared as the error code
-    PutBfrAddByte(&payloadBfrPair, -(pb));
-    ErrorTransition(myState);
+    ErrorTransition(myState, (Error_t) -(pb));
     pb = 0;
   }
   
@@ -169,41 +265,86 @@ Read in the length of the packet. If it's too short, raise an error.
 void DoStateL(StateVariables_t *myState){
   if(myState->c<ShortestPacket){
     // Raise an error if the packet is too short
-    PutBfrAddByte(&payloadBfrPair, ERR_LEN);
-    ErrorTransition(myState);
+    ErrorTransition(myState, ERR_LEN);
   }else{
-    // Calculate packet length
+    // Calculate packet length. The record is started once the
+    // destination is known.
     myState->payloadLen = myState->c - HeaderLength;
-    PutBfrAddByte(&payloadBfrPair, myState->payloadLen);
+    myState->bodySeen = 0;
+    myState->filter = TRUE;
     myState->parseState = R;
   }
 }
 
 /*--------------- D o S t a t e R ---------------
 Read in myState.payloadLen bytes, then validate the checksum and move on as 
-appropriate.
+appropriate. Takes as much of the packet as the n byte span holds and folds
+it into the checksum as a block. The part of the packet that completes it
+is validated where it lies in the span, and only copied to the payload
+buffer if the packet is good. A packet that fits in one span is therefore
+never copied unless it is good. A packet for another address is not copied
+at all, just checked. Returns the bytes used.
 */
-void DoStateR(StateVariables_t *myState){
-  OS_ERR osErr;
+CPU_INT16U DoStateR(StateVariables_t *myState, CPU_INT08U *span,
+                    CPU_INT16U n){
+  CPU_INT16U run = (n < myState->payloadLen) ? n : myState->payloadLen;
+  CPU_INT16U keep = 0;
+  CPU_INT16U k;
   
-  if(--myState->payloadLen > 0){
-    PutBfrAddByte(&payloadBfrPair, myState->c);
-  }else{
-    if(myState->checkSum){
-      // Reset put buffer so ERR_CHECKSUM is in the right place
-      PutBfrReset(&payloadBfrPair);
-      PutBfrAddByte(&payloadBfrPair, ERR_CHECKSUM);
-      ErrorTransition(myState);
+  // The trailing checksum or CRC is not kept
+  if(myState->payloadLen > TrailerLength)
+    keep = myState->payloadLen - TrailerLength;
+  if(keep > run)
+    keep = run;
+  
+  // Note the destination, source and type as they go by
+  for(k = 0; k < run && myState->bodySeen < MinBodyLength; k++)
+    myState->body[myState->bodySeen++] = span[k];
+  
+  // The destination is the first body byte. A packet for us gets its
+  // record; one that is not is read without keeping it. The record holds
+  // the body without the trailing check, so its length fits in a byte.
+  if(myState->filter){
+    myState->filter = FALSE;
+    if(promiscuous || AddrMapHas(myState->body[BodyDst])){
+      ReserveRecord(myState, PayloadHdrLength + myState->payloadLen -
+                    TrailerLength);
+      PutRecordHdr(myState, (Error_t) 0, myState->payloadLen - TrailerLength);
     }else{
-      myState->parseState = P;
-      ClosePutBfr(&payloadBfrPair);
-      if(BfrPairSwappable(&payloadBfrPair))
-        BfrPairSwap(&payloadBfrPair);
-      // Inform the OS that a payload buffer was closed
-      OSSemPost(&closedPayloadBfrs, OS_OPT_POST_1, &osErr);
-      assert(osErr==OS_ERR_NONE);
+      myState->skip = TRUE;
     }
   }
+  
+  myState->checkSum = ChkRun(myState->checkSum, span, run);
+  myState->payloadLen -= run;
+  
+  if(myState->payloadLen > 0){
+    // The packet goes on in the next span, so keep what is here
+    if(!myState->skip)
+      PutBfrAddBlock(&payloadBfrPair, span, keep);
+  }else if(myState->checkSum){
+    // Drop this record so ERR_CHECKSUM is in the right place
+    if(!myState->skip)
+      PutBfrRollback(&payloadBfrPair, myState->recordStart);
+    myState->skip = FALSE;
+    ErrorTransition(myState, ERR_CHECKSUM);
+  }else if(myState->skip){
+    // Good packet for another address
+    CountGood(myState);
+    stats.dropped[myState->body[BodyDst]]++;
+    myState->skip = FALSE;
+    myState->parseState = P;
+    myState->checkSum = ChkInit;
+  }else{
+    // Good packet: commit the rest of it in one block
+    PutBfrAddBlock(&payloadBfrPair, span, keep);
+    CountGood(myState);
+    myState->parseState = P;
+    myState->checkSum = ChkInit;
+    EndRecord();
+  }
+  
+  return run;
 }
 
 /*--------------- D o S t a t e E R ---------------
@@ -214,8 +355,10 @@ void DoStateER(StateVariables_t *myState){
   if (myState->c == myState->preamble[pb]){
     pb++;
   }else{ // If the wrong preamble byte is found, stay in error state
+    // The partial preamble and this byte are thrown away
+    stats.bytesSkipped += pb + 1;
     pb = 0;
-    myState->checkSum = 0;
+    myState->checkSum = ChkInit;
   }
   if(pb >= HeaderLength-1){
     myState->parseState = L; // Move on if preamble found
@@ -225,18 +368,85 @@ void DoStateER(StateVariables_t *myState){
 
 /*--------------- E r r o r T r a n s i t i o n ---------------
 Called when an error is found to handle progression to error state.
-Close and swap buffers, reset state variables as needed
+Record error e with an empty body, reset state variables as needed.
+The record carries the time of the last preamble start.
+*/
+void ErrorTransition(StateVariables_t *myState, Error_t e){
+  // After a checksum error's rollback this fits in the packet's room
+  ReserveRecord(myState, PayloadHdrLength);
+  PutRecordHdr(myState, e, 0);
+  EndRecord();
+  stats.errors[-e]++;
+  
+  myState->checkSum = ChkInit;
+  myState->parseState = ER;
+}
+
+/*--------------- P u t R e c o r d H d r ---------------
+Start a record with its status, body length and receive time
 */
-void ErrorTransition(StateVariables_t *myState){
+void PutRecordHdr(StateVariables_t *myState, Error_t status,
+                  CPU_INT08U len){
+  PutBfrAddByte(&payloadBfrPair, status);
+  PutBfrAddByte(&payloadBfrPair, len);
+  PutBfrAddBlock(&payloadBfrPair, (CPU_INT08U *) &myState->rxTs,
+                 sizeof(myState->rxTs));
+}
+
+/*--------------- C o u n t G o o d ---------------
+Count a good frame by message type and source
+*/
+void CountGood(StateVariables_t *myState){
+  stats.goodFrames++;
+  stats.byType[myState->body[BodyType]]++;
+  stats.bySource[myState->body[BodySrc]]++;
+}
+
+/*--------------- R e s e r v e R e c o r d ---------------
+Make sure the put buffer has room for an n byte record, handing over the
+records already in it if it does not, and note where the record starts.
+Waits for an open payload buffer once per buffer rather than once per
+record.
+*/
+void ReserveRecord(StateVariables_t *myState, CPU_INT16U n){
   OS_ERR osErr;
   
+  if(haveBfr && PutBfrFree(&payloadBfrPair) < n)
+    FlushRecords();
+  
+  if(!haveBfr){
+    OSSemPend(&openPayloadBfrs, SUSPEND_TIMEOUT, OS_OPT_PEND_BLOCKING, NULL, &osErr);
+    assert(osErr==OS_ERR_NONE);
+    haveBfr = TRUE;
+  }
+  
+  myState->recordStart = PutBfrMark(&payloadBfrPair);
+}
+
+/*--------------- E n d R e c o r d ---------------
+Called after each complete record. Hand the buffer over right away if the
+payload task is waiting for work or the buffer is full; otherwise keep
+packing records while the payload task is busy.
+*/
+void EndRecord(void){
+  if(PutBfrClosed(&payloadBfrPair) || !GetBfrClosed(&payloadBfrPair))
+    FlushRecords();
+}
+
+/*--------------- F l u s h R e c o r d s ---------------
+Close the put buffer and pass its records to the payload task
+*/
+void FlushRecords(void){
+  OS_ERR osErr;
+  
+  if(!haveBfr || PutBfrEmpty(&payloadBfrPair))
+    return;
+  
   ClosePutBfr(&payloadBfrPair);
   if(BfrPairSwappable(&payloadBfrPair))
     BfrPairSwap(&payloadBfrPair);
+  haveBfr = FALSE;
   // Inform the OS that a payload buffer was closed
   OSSemPost(&closedPayloadBfrs, OS_OPT_POST_1, &osErr);
   assert(osErr==OS_ERR_NONE);
-  
-  myState->checkSum=0;
-  myState->parseState = ER;
-}
\ No newline at end of file
+}
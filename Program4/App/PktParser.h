@@ -11,16 +11,36 @@ CHANGES
 02-19-2014 mn -  Initial submission
 03-12-2014 mn -  ParsePkt is not needed by external modules, replaced with
                  CreateParsePktTask
+10-19-2026 mn -  Added the destination filter switch and drop counts
+10-19-2026 mn -  Added the parser statistics block
 */
 
 #ifndef PKTPARSER_H
 #define PKTPARSER_H
 
+#include "Error.h"
+
+/*----- t y p e d e f s   u s e d   b y   t h e   p a r s e r -----*/
+/* Parser statistics. Only the parser writes them, a whole 32 bit word at
+   a time, so any task can read them without a critical section. Counts
+   wrap around. Fields may be a packet apart from each other. */
+typedef struct{
+  CPU_INT32U goodFrames;
+  CPU_INT32U bytesSkipped;      // Discarded while hunting for a preamble
+  CPU_INT32U errors[NumErrors]; // By -Error_t
+  CPU_INT32U byType[256];       // Good frames by message type
+  CPU_INT32U bySource[256];     // Good frames by source node
+  CPU_INT32U dropped[256];      // Dropped by the filter, by destination
+} ParserStats;
+
 // Allow semaphores to be used by Payload.c
 extern OS_SEM openPayloadBfrs;
 extern OS_SEM closedPayloadBfrs;
 
 /*----- f u n c t i o n    p r o t o t y p e s -----*/
 void CreateParsePktTask(void);
+void ParserSetPromiscuous(CPU_BOOLEAN on);
+CPU_INT32U ParserDropCount(CPU_INT08U dstAddr);
+const volatile ParserStats *ParserGetStats(void);
 
 #endif
\ No newline at end of file
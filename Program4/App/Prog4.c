@@ -10,21 +10,24 @@ CHANGES
 01-29-2013 gpc -  Created
 02-26-2014 mn  -  Updated for interrupt driven IO, renamed to Prog3.
 03-12-2014 mn  -  Updated to use uCOS-III, renamed to Prog4.
+10-19-2026 mn  -  Set up the local address map.
+10-19-2026 mn  -  Start the reply task.
+10-19-2026 mn  -  Baud rate from SerLine.h.
 */
 
 #include "includes.h"
+#include "AddrMap.h"
 #include "Payload.h"
 #include "assert.h"
 #include "Intrpt.h"
 #include "PktParser.h"
+#include "ReplyQ.h"
 #include "SerIODriver.h"
 
 /*----- c o n s t a n t    d e f i n i t i o n s -----*/
 
-// Define RS232 baud rate.
 #define Init_STK_SIZE 128 // Init stack size
 #define Init_PRIO 2 // Init task priority
-#define BaudRate 9600 // Baud rate setting
 #define HIGH_WATER_LIMIT 10
 
 /*----- G l o b a l   V a r i a b l e s -----*/
@@ -106,14 +109,18 @@ static  void  Init (void *p_arg)
     CPU_IntDisMeasMaxCurReset();
 
     // Initialize USART2.
-    BSP_Ser_Init(BaudRate);
+    BSP_Ser_Init(SerBaudRate);
 
     // Initialize the serial I/O driver. 
     InitSerIO();
     
-    // Create the ParsePkt and Payload tasks.
+    // Accept packets for MyAddress until told otherwise.
+    AddrMapInit();
+    
+    // Create the ParsePkt, Payload and reply tasks.
     CreateParsePktTask();
     CreatePayloadTask();
+    CreateReplyQTask();
     
     // Delete the Init task.
     OSTaskDel(&initTCB, &err);
@@ -0,0 +1,377 @@
+/*--------------- R e p l y Q . c ---------------
+
+by: Michael Nickelson
+
+PURPOSE
+Bounded queue of formatted replies between the payload task and the
+serial output, and the reply task that drains it.
+Blocks move between a free list and one FIFO per priority class, both
+kept with interrupts disabled for a few instructions. The queuedBlks
+semaphore wakes the reply task. A reply dropped from a FIFO leaves its
+post behind, so the reply task checks the FIFOs after each wake up.
+The reply task takes a reply only when a token bucket filled at the line
+rate covers it. Replies then wait in their class queue, where a higher
+class can pass them, rather than in the output buffer, where it cannot.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Queue per priority class, sends paced by a token bucket,
+                 low priority repeats coalesced, per class statistics
+10-19-2026 mn -  Paced to the line rate of SerLine.h
+10-19-2026 mn -  Constant messages written to the output buffer from their
+                 tables
+10-19-2026 mn -  Stack sized from the deepest call chain
+*/
+
+#include "includes.h"
+#include "ReplyQ.h"
+#include "assert.h"
+#include "Clock.h"
+#include "LatHist.h"
+#include "SerIODriver.h"
+#include "string.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define ReplyQPrio 5            /* Below the parser and payload tasks */
+// Words of stack. The task takes 96 bytes, and the deepest chain under
+// it is PutReserve waiting on the output buffers: 64 bytes, with the
+// kernel's pend allowed 128. An interrupt and a context switch add 64,
+// so 352 bytes or 88 words in all. The sizes came from a 32 bit x86 build
+// with gcc -fstack-usage, so they get half again as margin. Check it
+// with OSTaskStkChk() on the board.
+#define REPLYQ_STK_SIZE 192
+#define HIGH_WATER_LIMIT 10
+
+#if NumReplyBlks < 2
+#error "NumReplyBlks must allow one reply queued while one is sent"
+#endif
+
+#if OBfrSize < ReplyBlkSize
+#error "OBfrSize must hold a whole reply block"
+#endif
+
+#if TxBurst < ReplyBlkSize
+#error "TxBurst must cover a whole reply block"
+#endif
+
+/*----- l o c a l   f u n c t i o n    p r o t o t y p e s -----*/
+static void ReplyQTask(void *data);
+static ReplyBlk *ReplyQNext(OS_TICK *wait);
+static void TxRefill(void);
+static ReplyBlk *Dequeue(ReplyPrio_t prio);
+static const CPU_CHAR *ReplyText(const ReplyBlk *blk);
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+static ReplyBlk blks[NumReplyBlks];
+
+// Blocks not in use
+static ReplyBlk *freeBlks[NumReplyBlks];
+static CPU_INT16U numFree;
+
+// Replies waiting to be sent by class, oldest at head
+static ReplyBlk *queue[NumPrios][NumReplyBlks];
+static CPU_INT16U head[NumPrios];
+static CPU_INT16U queued[NumPrios];
+
+static OS_SEM queuedBlks;
+static volatile ReplyDrop_t policy = ReplyDropPolicy;
+static ReplyClassStats stats[NumPrios];
+
+// Token bucket, in bytes times the tick rate so a tick adds a whole
+// number of tokens. Only the reply task uses it.
+static CPU_INT32U tokens;
+static OS_TICK lastFill;
+
+// Task TCB and stack
+static OS_TCB replyQTCB;
+static CPU_STK replyQStk[REPLYQ_STK_SIZE];
+
+/*--------------- C r e a t e R e p l y Q T a s k ---------------
+Fill the free list and start the reply task
+*/
+void CreateReplyQTask(void){
+  OS_ERR osErr;
+  CPU_INT16U i;
+  
+  for(i = 0; i < NumReplyBlks; i++)
+    freeBlks[i] = &blks[i];
+  numFree = NumReplyBlks;
+  
+  // The line starts idle
+  tokens = TxBurst * OSCfg_TickRate_Hz;
+  lastFill = OSTimeGet(&osErr);
+  
+  OSSemCreate(&queuedBlks, "Queued replies", 0, &osErr);
+  assert(osErr == OS_ERR_NONE);
+  
+  OSTaskCreate(&replyQTCB,
+               "Reply task",
+               ReplyQTask,
+               NULL,
+               ReplyQPrio,
+               &replyQStk[0],
+               REPLYQ_STK_SIZE / HIGH_WATER_LIMIT,
+               REPLYQ_STK_SIZE,
+               0,
+               0,
+               (void *)0,
+               0,
+               &osErr);
+  
+  assert(osErr == OS_ERR_NONE);
+}
+
+/*--------------- R e p l y Q T a s k ---------------
+Send queued replies, highest class first, at the line rate. Only this
+task waits on the transmitter.
+*/
+static void ReplyQTask(void *data){
+  CPU_ERR cpuErr;
+  CPU_TS tsPerUs = CPU_TS_TmrFreqGet(&cpuErr) / UsPerSec;
+  ReplyClassStats *s;
+  ReplyBlk *blk;
+  CPU_INT32U us;
+  OS_TICK wait;
+  OS_ERR osErr;
+  
+  for(;;){
+    OSSemPend(&queuedBlks, 0, OS_OPT_PEND_BLOCKING, NULL, &osErr);
+    assert(osErr == OS_ERR_NONE);
+  
+    // Wait for the tokens to send the best reply waiting. A better one
+    // may be queued meanwhile, so choose again after each wait.
+    while((blk = ReplyQNext(&wait)) == NULL && wait > 0){
+      OSTimeDly(wait, OS_OPT_TIME_DLY, &osErr);
+      assert(osErr == OS_ERR_NONE);
+    }
+    // The reply posted was dropped since
+    if(blk == NULL)
+      continue;
+  
+    s = &stats[blk->prio];
+    us = (CPU_TS_Get32() - blk->postTs) / tsPerUs;
+    s->sent++;
+    s->totalUs += us;
+    if(us > s->maxUs)
+      s->maxUs = us;
+  
+#if LATENCY_HIST
+    LatHistMark(blk->msgType, blk->rxTs, blk->len);
+#endif
+    // Replies wait their turn in the class queues, so they are formatted
+    // into their blocks rather than the output buffer. The copy takes a
+    // few microseconds; each byte takes about a millisecond on the line.
+    // Constant messages are copied straight from their tables.
+    memcpy(PutReserve(blk->len), ReplyText(blk), blk->len);
+    PutCommit(blk->len);
+    ReplyQFree(blk);
+  }
+}
+
+/*--------------- R e p l y Q N e x t ---------------
+Take the first reply of the highest class waiting if the bucket holds its
+tokens. Otherwise return NULL, with the ticks until it will in wait, or
+0 in wait if no reply is waiting.
+*/
+static ReplyBlk *ReplyQNext(OS_TICK *wait){
+  ReplyBlk *blk = NULL;
+  CPU_INT32U cost = 0;
+  CPU_INT16S prio;
+  CPU_SR_ALLOC();
+  
+  TxRefill();
+  
+  CPU_CRITICAL_ENTER();
+  for(prio = NumPrios - 1; prio >= 0 && queued[prio] == 0; prio--)
+    ;
+  if(prio >= 0){
+    cost = (CPU_INT32U) queue[prio][head[prio]]->len * OSCfg_TickRate_Hz;
+    if(cost <= tokens)
+      blk = Dequeue((ReplyPrio_t) prio);
+  }
+  CPU_CRITICAL_EXIT();
+  
+  *wait = 0;
+  if(blk != NULL)
+    tokens -= cost;
+  else if(prio >= 0)
+    *wait = (cost - tokens + SerBytesPerSec - 1) / SerBytesPerSec;
+  
+  return blk;
+}
+
+/*--------------- T x R e f i l l ---------------
+Add the tokens for the ticks since the last fill, up to TxBurst bytes
+*/
+static void TxRefill(void){
+  CPU_INT32U full = TxBurst * OSCfg_TickRate_Hz;
+  OS_TICK now;
+  OS_TICK ticks;
+  OS_ERR osErr;
+  
+  now = OSTimeGet(&osErr);
+  ticks = now - lastFill;
+  lastFill = now;
+  // Long idle times would overflow the product
+  if(ticks >= (full - tokens) / SerBytesPerSec)
+    tokens = full;
+  else
+    tokens += ticks * SerBytesPerSec;
+}
+
+/*--------------- D e q u e u e ---------------
+Remove the first reply of a class. Called with interrupts disabled.
+*/
+static ReplyBlk *Dequeue(ReplyPrio_t prio){
+  ReplyBlk *blk = queue[prio][head[prio]];
+  
+  head[prio] = (head[prio] + 1) % NumReplyBlks;
+  queued[prio]--;
+  
+  return blk;
+}
+
+/*--------------- R e p l y T e x t ---------------
+Return the characters of a reply, in its block or in a message table
+*/
+static const CPU_CHAR *ReplyText(const ReplyBlk *blk){
+  return (blk->msg != NULL) ? blk->msg : blk->text;
+}
+
+/*--------------- R e p l y Q A l l o c ---------------
+Return a block for a text reply of priority prio, without waiting. If
+none is free a queued reply is dropped to make room. Returns NULL if the
+policy drops the new reply instead.
+*/
+ReplyBlk *ReplyQAlloc(ReplyPrio_t prio){
+  ReplyBlk *blk = NULL;
+  ReplyBlk *first;
+  CPU_INT16S victim = -1;
+  CPU_INT16S c;
+  CPU_SR_ALLOC();
+  
+  CPU_CRITICAL_ENTER();
+  if(numFree > 0){
+    blk = freeBlks[--numFree];
+  }else{
+    // The reply task holds at most one block, so some are queued. The
+    // victim is the first of its class: the oldest of all for
+    // DROP_OLDEST, the first of the lowest class for DROP_LOWEST.
+    for(c = 0; c < NumPrios; c++){
+      if(queued[c] == 0)
+        continue;
+      first = queue[c][head[c]];
+      if(victim < 0 || (policy == DROP_OLDEST &&
+         (CPU_INT32S) (first->postTs - queue[victim][head[victim]]->postTs) < 0))
+        victim = c;
+    }
+    if(policy == DROP_LOWEST && prio < victim){
+      stats[prio].dropped++;
+    }else{
+      blk = Dequeue((ReplyPrio_t) victim);
+      stats[victim].dropped++;
+    }
+  }
+  CPU_CRITICAL_EXIT();
+  
+  if(blk != NULL){
+    blk->prio = prio;
+    blk->msg = NULL;
+  }
+  
+  return blk;
+}
+
+/*--------------- R e p l y Q P o s t ---------------
+Queue a reply block filled in by the caller, with len characters of text
+or, with msg set, of a constant message. A low priority reply the same as
+the last one waiting in its class is coalesced into it.
+*/
+void ReplyQPost(ReplyBlk *blk){
+  ReplyPrio_t prio = blk->prio;
+  ReplyBlk *last = NULL;
+  OS_ERR osErr;
+  CPU_SR_ALLOC();
+  
+  CPU_CRITICAL_ENTER();
+  if(prio == PRIO_LOW && queued[prio] > 0)
+    last = queue[prio][(head[prio] + queued[prio] - 1) % NumReplyBlks];
+  CPU_CRITICAL_EXIT();
+  
+  // Only this task fills blocks, so last cannot change while it is
+  // compared, though it may be sent. It is coalesced into only if it is
+  // still waiting after.
+  if(last != NULL && last->len == blk->len &&
+     memcmp(ReplyText(last), ReplyText(blk), blk->len) == 0){
+    CPU_CRITICAL_ENTER();
+    if(queued[prio] > 0 &&
+       queue[prio][(head[prio] + queued[prio] - 1) % NumReplyBlks] == last){
+      stats[prio].coalesced++;
+      freeBlks[numFree++] = blk;
+      blk = NULL;
+    }
+    CPU_CRITICAL_EXIT();
+    if(blk == NULL)
+      return;
+  }
+  
+  blk->postTs = CPU_TS_Get32();
+  CPU_CRITICAL_ENTER();
+  queue[prio][(head[prio] + queued[prio]) % NumReplyBlks] = blk;
+  queued[prio]++;
+  CPU_CRITICAL_EXIT();
+  
+  OSSemPost(&queuedBlks, OS_OPT_POST_1, &osErr);
+  assert(osErr == OS_ERR_NONE);
+}
+
+/*--------------- R e p l y Q F r e e ---------------
+Give back a block without sending it
+*/
+void ReplyQFree(ReplyBlk *blk){
+  CPU_SR_ALLOC();
+  
+  CPU_CRITICAL_ENTER();
+  freeBlks[numFree++] = blk;
+  CPU_CRITICAL_EXIT();
+}
+
+/*--------------- R e p l y Q S e t P o l i c y ---------------
+Select which reply is dropped when the queue is full
+*/
+void ReplyQSetPolicy(ReplyDrop_t p){
+  policy = p;
+}
+
+/*--------------- R e p l y Q D e p t h ---------------
+Return the number of replies waiting to be sent
+*/
+CPU_INT16U ReplyQDepth(void){
+  CPU_INT16U n = 0;
+  CPU_INT16U c;
+  
+  for(c = 0; c < NumPrios; c++)
+    n += queued[c];
+  
+  return n;
+}
+
+/*--------------- R e p l y Q D r o p p e d ---------------
+Return the number of replies dropped because the queue was full
+*/
+CPU_INT32U ReplyQDropped(void){
+  CPU_INT32U n = 0;
+  CPU_INT16U c;
+  
+  for(c = 0; c < NumPrios; c++)
+    n += stats[c].dropped;
+  
+  return n;
+}
+
+/*--------------- R e p l y Q S t a t s ---------------
+Return the statistics of a priority class
+*/
+const ReplyClassStats *ReplyQStats(ReplyPrio_t prio){
+  return &stats[prio];
+}
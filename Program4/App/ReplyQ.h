@@ -0,0 +1,90 @@
+/*--------------- R e p l y Q . h ---------------
+
+by: Michael Nickelson
+
+PURPOSE - Header file
+Bounded queue of formatted replies between the payload task and the
+serial output. The payload task formats each reply into a block taken
+from the queue's pool and posts it, and never waits on the transmitter.
+The reply task hands queued blocks to the serial driver, highest
+priority class first and in order within a class, no faster than the line
+can send them. When every block is in use, one reply is dropped by the
+drop policy.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Queue per priority class, sends paced by a token bucket,
+                 low priority repeats coalesced, per class statistics
+10-19-2026 mn -  Paced to the line rate of SerLine.h
+10-19-2026 mn -  Blocks may point at a constant message instead of text
+*/
+
+#ifndef REPLYQ_H
+#define REPLYQ_H
+
+#include "includes.h"
+
+/* Number of reply blocks, queued and being sent */
+#ifndef NumReplyBlks
+#define NumReplyBlks 8
+#endif
+
+/* Characters a reply block holds */
+#ifndef ReplyBlkSize
+#define ReplyBlkSize 192
+#endif
+
+/* Drop policy at start up, a ReplyDrop_t */
+#ifndef ReplyDropPolicy
+#define ReplyDropPolicy DROP_OLDEST
+#endif
+
+/* Bytes that may go out at once after the line has been idle. At least
+   one reply block, so any reply gets through. */
+#ifndef TxBurst
+#define TxBurst ReplyBlkSize
+#endif
+
+/*----- t y p e d e f s   u s e d   i n   t h e   r e p l y   q u e u e -----*/
+/* Which reply goes when the queue is full. DROP_LOWEST drops the oldest of
+   the lowest priority replies, the new one included. */
+typedef enum {DROP_OLDEST, DROP_LOWEST, NumDropPolicies} ReplyDrop_t;
+
+/* Reply priority classes. Each has its own queue; the highest class with
+   a reply waiting is sent first. Diagnostics are high, readings normal,
+   and errors, error summaries and info replies low. */
+typedef enum {PRIO_LOW, PRIO_NORMAL, PRIO_HIGH, NumPrios} ReplyPrio_t;
+
+typedef struct
+{
+  ReplyPrio_t prio;
+  CPU_INT08U msgType;           // For the latency histograms
+  CPU_TS rxTs;                  // Receive time of the packet replied to
+  CPU_TS postTs;                // Time the reply was queued
+  const CPU_CHAR *msg;          // Constant message sent from its table,
+                                // or NULL to send text
+  CPU_INT16U len;               // Characters in msg or text
+  CPU_CHAR text[ReplyBlkSize];
+} ReplyBlk;
+
+/* What became of the replies of one class */
+typedef struct
+{
+  CPU_INT32U sent;
+  CPU_INT32U dropped;           // For want of a block
+  CPU_INT32U coalesced;         // Same as the one waiting before it
+  CPU_INT32U maxUs;             // Longest wait in the queue
+  CPU_INT64U totalUs;           // Of the waits of the replies sent
+} ReplyClassStats;
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void CreateReplyQTask(void);
+ReplyBlk *ReplyQAlloc(ReplyPrio_t prio);
+void ReplyQPost(ReplyBlk *blk);
+void ReplyQFree(ReplyBlk *blk);
+void ReplyQSetPolicy(ReplyDrop_t policy);
+CPU_INT16U ReplyQDepth(void);
+CPU_INT32U ReplyQDropped(void);
+const ReplyClassStats *ReplyQStats(ReplyPrio_t prio);
+
+#endif
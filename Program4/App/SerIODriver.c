@@ -8,36 +8,64 @@ This module sets up serial IO and appropriate buffers
 CHANGES
 02-19-2014 mn -  Initial submission
 03-12-2014 mn -  Updated to use uCOS-III and semaphores
+10-19-2026 mn -  Added span access to the input buffers
+10-19-2026 mn -  Separate input buffer size, close input buffers on idle line
+10-19-2026 mn -  GetSpan takes a timeout
+10-19-2026 mn -  Receive time stamps on input spans
+10-19-2026 mn -  Count sent bytes for the latency histograms
+10-19-2026 mn -  Replies are written in place in the output buffers, and a
+                 partly filled output buffer is sent once the line is free
+10-19-2026 mn -  Line rate from SerLine.h
+10-19-2026 mn -  Open output buffers posted only to a waiting PutReserve
 */
 
 #include "SerIODriver.h"
+#include "LatHist.h"
 #include "assert.h"
 #include "Buffer.h"
 
 /*----- Constant definitions ----- */
 #define RXNE_MASK 0x0020
+#define IDLE_MASK 0x0010
 #define TXE_MASK 0x0080
 #define USART2ENA 0x00000040
 #define TXEIE_MASK 0x0080
 #define RXNEIE_MASK 0x0020
+#define IDLEIE_MASK 0x0010
 #define SETENA1 (*((CPU_INT32U *) 0xE000E104))
 #define CLRENA1 (*((CPU_INT32U *) 0xE000E184))
 #define NUM_BFRS 2
-#define SUSPEND_TIMEOUT 250
+
+#if SerBaudRate != 9600
+#error "uart->BRR in InitSerIO is set for 9600 baud"
+#endif
 
 /*----- Local Function prototypes -----*/
 void ServiceRx();
 void ServiceTx();
+static void FlushTx(void);
 
 /*----- Global Variables -----*/
 // Declare input and output buffer pairs
 static BfrPair iBfrPair;
-static CPU_INT08U iBfr0Space[BfrSize];
-static CPU_INT08U iBfr1Space[BfrSize];
+static CPU_INT08U iBfr0Space[IBfrSize];
+static CPU_INT08U iBfr1Space[IBfrSize];
 
 static BfrPair oBfrPair;
-static CPU_INT08U oBfr0Space[BfrSize];
-static CPU_INT08U oBfr1Space[BfrSize];
+static CPU_INT08U oBfr0Space[OBfrSize];
+static CPU_INT08U oBfr1Space[OBfrSize];
+
+// Set while space from PutReserve is being written
+static volatile CPU_BOOLEAN oReserved = FALSE;
+
+// Set while PutReserve waits on openObfrs. Only then does the interrupt
+// post it, so the count never runs ahead of the waits.
+static volatile CPU_BOOLEAN oWaiting = FALSE;
+
+// Receive time of the first byte in each input buffer, and the time one
+// byte takes on the line, both in CPU_TS ticks
+static CPU_TS iBfrTs[NUM_BFRS];
+static CPU_TS byteTime;
 
 // Declare openObfrs and closedIBfrs semaphores
 static OS_SEM openObfrs;
@@ -63,6 +91,7 @@ Configure HW and initialize buffers
 */
 void InitSerIO(){
   OS_ERR osErr;
+  CPU_ERR cpuErr;
   
   USART_TypeDef *uart = USART2;
   
@@ -70,8 +99,8 @@ void InitSerIO(){
   uart->BRR = 0x0EA6;
   
   /* Enable UART, Tx, and Rx
-  as well as interrupts. */
-  uart->CR1 = 0x20AC;
+  as well as interrupts, including idle line. */
+  uart->CR1 = 0x20AC | IDLEIE_MASK;
   
   // Set 1 stop bit
   uart->CR2 = 0x0000;
@@ -88,12 +117,15 @@ void InitSerIO(){
   // Enable interrupts on USART2
   SETENA1 = USART2ENA;
   
+  // Time stamps count CPU_TS timer ticks
+  byteTime = CPU_TS_TmrFreqGet(&cpuErr) / SerBytesPerSec;
+  
   // Initialize iBfrPair and oBfrPair
-  BfrPairInit(&iBfrPair, iBfr0Space, iBfr1Space, BfrSize);
-  BfrPairInit(&oBfrPair, oBfr0Space, oBfr1Space, BfrSize);
+  BfrPairInit(&iBfrPair, iBfr0Space, iBfr1Space, IBfrSize);
+  BfrPairInit(&oBfrPair, oBfr0Space, oBfr1Space, OBfrSize);
   
   // Initialize semaphores to be used by Serial communications driver
-  OSSemCreate(&openObfrs, "Open oBfrs", NUM_BFRS, &osErr);
+  OSSemCreate(&openObfrs, "Open oBfrs", 0, &osErr);
   assert(osErr == OS_ERR_NONE);
   OSSemCreate(&closedIBfrs, "Closed iBfrs", 0, &osErr);
   assert(osErr == OS_ERR_NONE);
@@ -103,13 +135,20 @@ void InitSerIO(){
 If a new byte is available in the Status Register and the iBfrPair put 
 buffer is open, grab it and put it into the iBfrPair PutBfr.
 Swap buffers as needed.
+When the line goes idle, close a partly filled put buffer so the bytes
+received so far are not held back waiting for it to fill.
+The first byte in each buffer is time stamped.
 */
 void ServiceRx(){
   USART_TypeDef *uart = USART2;
+  CPU_INT16U sr = uart->SR;
   OS_ERR osErr;
   
-  if((uart->SR) & RXNE_MASK){
+  if(sr & RXNE_MASK){
     if(!PutBfrClosed(&iBfrPair)){
+      if(PutBfrEmpty(&iBfrPair))
+        iBfrTs[iBfrPair.putBrfNum] = CPU_TS_Get32();
+      // Reading DR also clears the idle flag
       PutBfrAddByte(&iBfrPair, uart->DR);
       // If the put buffer closes, inform the OS.
       if(PutBfrClosed(&iBfrPair)){
@@ -117,14 +156,26 @@ void ServiceRx(){
         assert(osErr==OS_ERR_NONE);
       }
     }else{
-      uart->CR1 = uart->CR1 ^ RXNEIE_MASK;
+      // Leave the byte in DR until a buffer opens
+      uart->CR1 = uart->CR1 & ~(RXNEIE_MASK | IDLEIE_MASK);
+      return;
     }
+  }else if(sr & IDLE_MASK){
+    // Nothing is waiting in DR, so reading it only clears the idle flag
+    (void) uart->DR;
+  }
+  
+  if((sr & IDLE_MASK) &&
+     !PutBfrClosed(&iBfrPair) && !PutBfrEmpty(&iBfrPair)){
+    ClosePutBfr(&iBfrPair);
+    OSSemPost(&closedIBfrs, OS_OPT_POST_1, &osErr);
+    assert(osErr==OS_ERR_NONE);
   }
 }
 
 /*----------- ServiceTx() -----------
 If the Get buffer is closed, start dumping it out to the UART.
-Swap buffers as needed.
+When it empties, start on whatever is waiting in the put buffer.
 */
 void ServiceTx(){
   USART_TypeDef *uart = USART2;
@@ -135,14 +186,21 @@ void ServiceTx(){
     if(GetBfrClosed(&oBfrPair)){
       c = GetBfrRemByte(&oBfrPair);
       uart->DR = c;
+#if LATENCY_HIST
+      LatHistTxByte();
+#endif
       
-      // If the buffer opens, inform the OS
+      // If the buffer opens, inform a waiting PutReserve
       if(!GetBfrClosed(&oBfrPair)){
-        OSSemPost(&openObfrs, OS_OPT_POST_1, &osErr);
-        assert(osErr==OS_ERR_NONE);
+        FlushTx();
+        if(oWaiting){
+          oWaiting = FALSE;
+          OSSemPost(&openObfrs, OS_OPT_POST_1, &osErr);
+          assert(osErr==OS_ERR_NONE);
+        }
       }
     }else{
-      uart->CR1 = uart->CR1 ^ TXEIE_MASK;
+      uart->CR1 = uart->CR1 & ~TXEIE_MASK;
     }
   }
 }
@@ -165,33 +223,135 @@ CPU_INT16S GetByte(){
   }
      
   if(GetBfrClosed(&iBfrPair)){
-    uart->CR1 = uart->CR1 | RXNEIE_MASK;
+    uart->CR1 = uart->CR1 | RXNEIE_MASK | IDLEIE_MASK;
     retVal = GetBfrRemByte(&iBfrPair);
   }
   
   return retVal;
 }
 
+/*----------- GetSpan() -----------
+Wait for a closed input buffer, point span at its unread bytes and return
+how many there are. The bytes stay put until released with SkipSpan, so
+the caller can work on them in place.
+Waits at most timeout ticks, 0 for no limit. Returns 0 if it timed out.
+ts is set to the receive time of span[0]. Bytes in a span arrived back to
+back, so byte i came in i * SerByteTime() later.
+*/
+CPU_INT16U GetSpan(CPU_INT08U **span, CPU_TS *ts, OS_TICK timeout){
+  OS_ERR osErr;
+  CPU_INT16U n;
+  
+  if(!GetBfrClosed(&iBfrPair)){
+    OSSemPend(&closedIBfrs, timeout, OS_OPT_PEND_BLOCKING, NULL, &osErr);
+    if(osErr == OS_ERR_TIMEOUT)
+      return 0;
+    assert(osErr == OS_ERR_NONE);
+    
+    if(BfrPairSwappable(&iBfrPair))
+      BfrPairSwap(&iBfrPair);
+  }
+  
+  n = GetBfrSpan(&iBfrPair, span);
+  *ts = iBfrTs[!iBfrPair.putBrfNum] + 
+        (CPU_TS) (*span - GetBfrAddr(&iBfrPair)) * byteTime;
+  
+  return n;
+}
+
+/*----------- SerByteTime() -----------
+Return the time one byte takes on the line, in CPU_TS ticks.
+*/
+CPU_TS SerByteTime(void){
+  return byteTime;
+}
+
+/*----------- SkipSpan() -----------
+Release n bytes returned by GetSpan.
+*/
+void SkipSpan(CPU_INT16U n){
+  USART_TypeDef *uart = USART2;
+  
+  GetBfrSkip(&iBfrPair, n);
+  uart->CR1 = uart->CR1 | RXNEIE_MASK | IDLEIE_MASK;
+}
+
 /*----------- PutByte() -----------
-Send a byte to the output put buffer.
-A negative return value indicates a full buffer
+Send a byte to the output put buffer, waiting for room if need be.
 */
 CPU_INT16S PutByte(CPU_INT16S txChar){
-  CPU_INT16S retVal = -1;
+  *PutReserve(1) = txChar;
+  PutCommit(1);
+  
+  return txChar;
+}
+
+/*----------- PutReserve() -----------
+Wait until the output put buffer has n free bytes in a row and return
+where they start. The caller writes up to n bytes there and hands them to
+the transmitter with PutCommit, so a reply goes in as one block rather
+than a byte at a time. n must not be more than OBfrSize.
+*/
+CPU_INT08U *PutReserve(CPU_INT16U n){
   USART_TypeDef *uart = USART2;
+  CPU_INT08U *space;
   OS_ERR osErr;
-
-  if(PutBfrClosed(&oBfrPair)){
-    OSSemPend(&openObfrs, SUSPEND_TIMEOUT, OS_OPT_PEND_BLOCKING, NULL, &osErr);
-    assert(osErr == OS_ERR_NONE);
-    
-    if(BfrPairSwappable(&oBfrPair))
+  CPU_SR_ALLOC();
+  
+  assert(n <= OBfrSize);
+  
+  for(;;){
+    CPU_CRITICAL_ENTER();
+    // Send what is there rather than split the reservation across buffers
+    if(PutBfrFree(&oBfrPair) < n && !PutBfrClosed(&oBfrPair))
+      ClosePutBfr(&oBfrPair);
+    if(BfrPairSwappable(&oBfrPair)){
       BfrPairSwap(&oBfrPair);
+      uart->CR1 = uart->CR1 | TXEIE_MASK;
+    }
+    if(PutBfrFree(&oBfrPair) >= n){
+      oReserved = TRUE;
+      space = PutBfrSpace(&oBfrPair);
+      CPU_CRITICAL_EXIT();
+      return space;
+    }
+    oWaiting = TRUE;
+    CPU_CRITICAL_EXIT();
+    
+    // Both buffers are full, so wait for the transmitter to empty one
+    OSSemPend(&openObfrs, 0, OS_OPT_PEND_BLOCKING, NULL, &osErr);
+    assert(osErr == OS_ERR_NONE);
   }
+}
+
+/*----------- PutCommit() -----------
+Hand the first n bytes written at the PutReserve address to the
+transmitter. If it is idle they go out straight away.
+*/
+void PutCommit(CPU_INT16U n){
+  CPU_SR_ALLOC();
   
-  PutBfrAddByte(&oBfrPair,txChar);
-  retVal = txChar;
-  uart->CR1 = uart->CR1 | TXEIE_MASK;
+  CPU_CRITICAL_ENTER();
+  PutBfrCommit(&oBfrPair, n);
+  oReserved = FALSE;
+  FlushTx();
+  CPU_CRITICAL_EXIT();
+}
+
+/*----------- FlushTx() -----------
+If the transmitter has emptied the get buffer and no reply is being
+written, close a partly filled put buffer and start sending it. Without
+this the tail of a reply would sit in the put buffer until the next reply
+filled it. Called from the interrupt or with interrupts disabled.
+*/
+static void FlushTx(void){
+  USART_TypeDef *uart = USART2;
   
-  return retVal;
+  if(oReserved || GetBfrClosed(&oBfrPair) || PutBfrEmpty(&oBfrPair))
+    return;
+  
+  if(!PutBfrClosed(&oBfrPair))
+    ClosePutBfr(&oBfrPair);
+  BfrPairSwap(&oBfrPair);
+  uart->CR1 = uart->CR1 | TXEIE_MASK;
 }
\ No newline at end of file
@@ -9,6 +9,12 @@ This module sets up serial IO and appropriate buffers
 CHANGES
 02-19-2014 mn -  Initial submission
 03-12-2014 mn -  Updated to use uCOS-III and semaphores
+10-19-2026 mn -  Added span access to the input buffers
+10-19-2026 mn -  Separate input buffer size, close input buffers on idle line
+10-19-2026 mn -  GetSpan takes a timeout
+10-19-2026 mn -  Receive time stamps on input spans
+10-19-2026 mn -  Replies are written in place in the output buffers
+10-19-2026 mn -  Line rate moved to SerLine.h
 */
 
 #ifndef SERIODRIVER_H
@@ -16,10 +22,18 @@ CHANGES
 
 #include "includes.h"
 #include "BfrPair.h"
+#include "SerLine.h"
 
-/* Variable size for input and output buffers */
-#ifndef BfrSize
-#define BfrSize 4
+/* Size of the output buffers. A reply goes into one output buffer whole,
+   so they must hold the longest reply. */
+#ifndef OBfrSize
+#define OBfrSize 256
+#endif
+
+/* Size of the input buffers. A packet that fits in one input buffer is
+   validated in place before it is copied to the payload buffer. */
+#ifndef IBfrSize
+#define IBfrSize 32
 #endif
 
 /*----- f u n c t i o n    p r o t o t y p e s -----*/
@@ -27,5 +41,10 @@ void SerialISR(void);
 void InitSerIO();
 CPU_INT16S GetByte(void);
 CPU_INT16S PutByte(CPU_INT16S txChar);
+CPU_INT08U *PutReserve(CPU_INT16U n);
+void PutCommit(CPU_INT16U n);
+CPU_INT16U GetSpan(CPU_INT08U **span, CPU_TS *ts, OS_TICK timeout);
+CPU_TS SerByteTime(void);
+void SkipSpan(CPU_INT16U n);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,22 @@
+/*--------------- S e r L i n e . h ---------------
+
+by: Michael Nickelson
+
+PURPOSE - Header file
+Rate of the serial line. The driver sets the UART up from it, the reply
+task paces replies to it and the host reply decoder works out line
+throughput from it, so all three agree.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+*/
+
+#ifndef SERLINE_H
+#define SERLINE_H
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define SerBaudRate 9600
+#define SerBitsPerByte 10       /* Start, 8 data and stop bits */
+#define SerBytesPerSec (SerBaudRate / SerBitsPerByte)
+
+#endif
@@ -0,0 +1,27 @@
+/*--------------- B e n c h . c ---------------
+
+by: Michael Nickelson
+
+PURPOSE
+Timing shared by the host benchmarks and tools.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+*/
+
+#include "includes.h"
+#include <time.h>
+#include "Bench.h"
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+volatile CPU_INT64U benchSink;
+
+/*--------------- B e n c h N o w ---------------
+Monotonic time in seconds.
+*/
+double BenchNow(void){
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
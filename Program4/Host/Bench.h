@@ -0,0 +1,33 @@
+/*--------------- B e n c h . h ---------------
+
+by: Michael Nickelson
+
+PURPOSE - Header file
+Timing shared by the host benchmarks and tools: a monotonic clock in
+seconds, the x86 time stamp counter, and a sink the timed loops store a
+result to so the compiler keeps their work. Elsewhere than x86 the cycle
+count is 0.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+*/
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "includes.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BenchCycles() __rdtsc()
+#else
+#define BenchCycles() 0
+#endif
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+extern volatile CPU_INT64U benchSink;
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+double BenchNow(void);
+
+#endif
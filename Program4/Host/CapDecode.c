@@ -0,0 +1,675 @@
+/*--------------- C a p D e c o d e . c ---------------
+
+by: Michael Nickelson
+
+PURPOSE
+Offline decoder for captures of the sensor network RF link.
+The capture is mapped into memory and parsed in place by the HostParser
+state machine, with the kernel told the mapping will be read sequentially.
+Buffered reads through a small buffer can be selected instead so the two
+ingestion paths can be compared; the decoder prints the throughput of the
+path used.
+With -c the capture is taken to be framed with CRC-16 rather than the XOR
+checksum byte.
+With -j the mapped capture is cut into chunks that worker threads decode
+independently, each starting at the first plausible frame in its chunk.
+The chunk results are stitched back together in order so the output is
+the same as a serial decode.
+With -a the time stamps, wind speeds and precipitation depths of the good
+frames are gathered into columns, decoded in batches by HostCols and
+summarized.
+
+Build:  cc -O2 -pthread -I. -I../App -o CapDecode CapDecode.c HostParser.c \
+                    HostCols.c Bench.c ../App/FrameChk.c ../App/MsgDefs.c
+Usage:  CapDecode [-b bufsize | -j threads] [-a] [-c] [-v] capture
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Added parallel decoding of mapped captures
+10-19-2026 mn -  Resync with FrameCheck
+10-19-2026 mn -  Added -c for CRC-16 framed captures
+10-19-2026 mn -  Timed with BenchNow of Bench.h
+10-19-2026 mn -  Added -a for a summary of the time stamps and readings
+10-19-2026 mn -  Exit if a list or column cannot grow
+*/
+
+#include "includes.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Bench.h"
+#include "HostCols.h"
+#include "HostParser.h"
+#include "MsgDefs.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define NumErrs 7         /* Error_t runs from -1 to -6 */
+#define NumMsgTypes 256
+#define DstOffset 4       /* Offsets of header fields within a frame */
+#define SrcOffset 5
+#define TypeOffset 6
+#define DataOffset 7
+#define ChunkSize (16UL << 20)  /* Bytes of capture per parallel work item */
+#define BcdBytes 2        /* A 4 digit BCD reading */
+#define BatchSize 4096    /* Records decoded from the columns at a time */
+#define TimeTextSize 20
+
+/*----- t y p e d e f s   u s e d   b y   t h e   d e c o d e r -----*/
+/* A column of raw fields gathered from the frames */
+typedef struct{
+  CPU_INT08U *data;
+  size_t n;                 // Fields in data
+  size_t max;
+} Column;
+
+typedef struct{
+  CPU_BOOLEAN verbose;
+  CPU_BOOLEAN analyze;
+  CPU_INT08U trailer;       // Checksum or CRC bytes ending each frame
+  Column stamps;            // Packed date/time words, host byte order
+  Column speeds;            // BCD, as sent
+  Column depths;
+  CPU_INT64U frames;
+  CPU_INT64U errs[NumErrs];
+  CPU_INT64U types[NumMsgTypes];
+} Tally;
+
+/* A frame (code = frame length) or error (code = Error_t) found by a worker,
+   off is relative to the start of the worker's chunk */
+typedef struct{
+  CPU_INT32U off;
+  CPU_INT16S code;
+} Event;
+
+/* One parallel work item */
+typedef struct{
+  CPU_INT64U lo;            // Chunk bounds
+  CPU_INT64U hi;
+  Event *ev;                // Events found in the chunk, in stream order
+  size_t nEv;
+  size_t maxEv;
+  CPU_BOOLEAN done;
+} Chunk;
+
+/* State shared by the workers and the stitching thread */
+typedef struct{
+  const CPU_INT08U *cap;
+  CPU_INT64U size;
+  CPU_BOOLEAN crc;
+  Chunk *chunks;
+  size_t nChunks;
+  size_t next;              // Next chunk to hand to a worker
+  pthread_mutex_t lock;
+  pthread_cond_t chunkDone;
+} Work;
+
+/* Sequential parser that stitches the chunks together */
+typedef struct{
+  const CPU_INT08U *cap;
+  Tally *tally;
+  CPU_INT64U lastFrame;     // Offset of the last frame it found
+} Stitch;
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+static const char *ErrNames[NumErrs] = {"", "preamble 1", "preamble 2",
+                                        "preamble 3", "checksum", "length",
+                                        "message type"};
+
+/*----- l o c a l   f u n c t i o n    p r o t o t y p e s -----*/
+static void OnFrame(void *ctx, CPU_INT64U off, const CPU_INT08U *frame,
+                    CPU_INT16U len);
+static void OnErr(void *ctx, CPU_INT64U off, Error_t e);
+static int DecodeMapped(int fd, size_t size, HostParser *hp);
+static int DecodeBuffered(int fd, size_t bfrSize, HostParser *hp);
+static int DecodeParallel(int fd, size_t size, int threads, CPU_BOOLEAN crc,
+                          Tally *t);
+static void *Worker(void *arg);
+static CPU_INT64U Resync(const CPU_INT08U *cap, CPU_INT64U lo,
+                         CPU_INT64U hi, CPU_INT64U size, CPU_BOOLEAN crc);
+static void OnChunkFrame(void *ctx, CPU_INT64U off, const CPU_INT08U *frame,
+                         CPU_INT16U len);
+static void OnChunkErr(void *ctx, CPU_INT64U off, Error_t e);
+static void AddEvent(Chunk *ch, CPU_INT64U off, CPU_INT16S code);
+static void OnStitchFrame(void *ctx, CPU_INT64U off, const CPU_INT08U *frame,
+                          CPU_INT16U len);
+static void OnStitchErr(void *ctx, CPU_INT64U off, Error_t e);
+static void Gather(Tally *t, const CPU_INT08U *frame, CPU_INT16U len);
+static void *AddField(Column *c, size_t size);
+static void *Grow(void *p, size_t size);
+static void Report(const Tally *t, CPU_INT64U bytes, double secs);
+static void Analyze(const Tally *t);
+static CPU_INT64U SumBcd(const Column *c);
+static void TimeText(CPU_INT64S secs, char text[]);
+
+/*--------------- m a i n ( ) -----------------*/
+int main(int argc, char *argv[]){
+  static HostParser hp;
+  static Tally tally;
+  size_t bfrSize = 0;
+  CPU_BOOLEAN crc = FALSE;
+  int threads = 0;
+  struct stat st;
+  double start;
+  int opt;
+  int fd;
+  int rc;
+
+  while((opt = getopt(argc, argv, "ab:cj:v")) != -1){
+    switch(opt){
+      case 'a':
+        tally.analyze = TRUE;
+        break;
+      case 'b':
+        bfrSize = strtoul(optarg, NULL, 0);
+        break;
+      case 'c':
+        crc = TRUE;
+        break;
+      case 'j':
+        threads = atoi(optarg);
+        break;
+      case 'v':
+        tally.verbose = TRUE;
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-b bufsize | -j threads] [-a] [-c] [-v] capture\n",
+                argv[0]);
+        return 2;
+    }
+  }
+  if(optind >= argc){
+    fprintf(stderr, "usage: %s [-b bufsize | -j threads] [-a] [-c] [-v] capture\n",
+                argv[0]);
+    return 2;
+  }
+
+  fd = open(argv[optind], O_RDONLY);
+  if(fd < 0 || fstat(fd, &st) < 0){
+    perror(argv[optind]);
+    return 1;
+  }
+
+  FrameCrc16Init();
+  HostColsInit();
+  tally.trailer = crc ? CrcLength : ChkLength;
+  HostParserInit(&hp, 0, crc, OnFrame, OnErr, &tally);
+  start = BenchNow();
+  if(bfrSize){
+    rc = DecodeBuffered(fd, bfrSize, &hp);
+  }else if(threads > 0){
+    rc = DecodeParallel(fd, (size_t) st.st_size, threads, crc, &tally);
+    hp.offset = st.st_size;
+  }else{
+    rc = DecodeMapped(fd, (size_t) st.st_size, &hp);
+  }
+  if(rc == 0)
+    Report(&tally, hp.offset, BenchNow() - start);
+  if(rc == 0 && tally.analyze)
+    Analyze(&tally);
+
+  close(fd);
+  return rc;
+}
+
+/*--------------- D e c o d e M a p p e d ---------------
+Map the whole capture and parse it in place.
+*/
+static int DecodeMapped(int fd, size_t size, HostParser *hp){
+  const CPU_INT08U *cap;
+
+  if(size == 0)
+    return 0;
+  cap = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if(cap == MAP_FAILED){
+    perror("mmap");
+    return 1;
+  }
+  madvise((void *) cap, size, MADV_SEQUENTIAL);
+
+  HostParseSpan(hp, cap, size);
+
+  munmap((void *) cap, size);
+  return 0;
+}
+
+/*--------------- D e c o d e B u f f e r e d ---------------
+Read the capture through a buffer of bfrSize bytes. Frames that straddle
+two reads are carried over by the parser.
+*/
+static int DecodeBuffered(int fd, size_t bfrSize, HostParser *hp){
+  CPU_INT08U *bfr = malloc(bfrSize);
+  FILE *f = fdopen(dup(fd), "rb");
+  size_t n;
+
+  if(bfr == NULL || f == NULL){
+    perror("buffered read");
+    free(bfr);
+    return 1;
+  }
+  while((n = fread(bfr, 1, bfrSize, f)) > 0)
+    HostParseSpan(hp, bfr, n);
+
+  fclose(f);
+  free(bfr);
+  return 0;
+}
+
+/*--------------- D e c o d e P a r a l l e l ---------------
+Map the capture and decode it in chunks on several threads. Each worker
+starts its chunk at the first plausible frame and records what it finds.
+This thread stitches the chunks together in order: a sequential parser
+runs on from the end of the last accepted frame until it finds a frame
+that the next chunk's worker also found. From there the worker's results
+are the same as a serial decode would give, so they are taken as they are
+and the sequential parser skips to the end of the chunk's last frame.
+*/
+static int DecodeParallel(int fd, size_t size, int threads, CPU_BOOLEAN crc,
+                          Tally *t){
+  pthread_t *tids;
+  Work work;
+  Stitch stitch;
+  HostParser fix;
+  CPU_INT64U pos = 0;       // Bytes before pos have been accounted for
+  CPU_INT64U off;
+  CPU_INT64U end;
+  CPU_BOOLEAN synced;
+  Chunk *ch;
+  size_t k;
+  size_t j;
+  size_t n;
+  size_t last;
+  int err;
+  int i;
+
+  if(size == 0)
+    return 0;
+  work.cap = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if(work.cap == MAP_FAILED){
+    perror("mmap");
+    return 1;
+  }
+  madvise((void *) work.cap, size, MADV_SEQUENTIAL);
+
+  work.size = size;
+  work.crc = crc;
+  work.nChunks = (size + ChunkSize - 1) / ChunkSize;
+  work.chunks = Grow(NULL, work.nChunks * sizeof(Chunk));
+  memset(work.chunks, 0, work.nChunks * sizeof(Chunk));
+  work.next = 0;
+  for(k = 0; k < work.nChunks; k++){
+    work.chunks[k].lo = k * ChunkSize;
+    work.chunks[k].hi = (k+1 < work.nChunks) ? (k+1) * ChunkSize : size;
+  }
+  pthread_mutex_init(&work.lock, NULL);
+  pthread_cond_init(&work.chunkDone, NULL);
+
+  tids = Grow(NULL, threads * sizeof(pthread_t));
+  for(i = 0; i < threads; i++){
+    err = pthread_create(&tids[i], NULL, Worker, &work);
+    if(err != 0){
+      fprintf(stderr, "pthread_create: %s\n", strerror(err));
+      exit(1);
+    }
+  }
+
+  stitch.cap = work.cap;
+  stitch.tally = t;
+  stitch.lastFrame = ~(CPU_INT64U) 0;
+  HostParserInit(&fix, 0, crc, OnStitchFrame, OnStitchErr, &stitch);
+
+  for(k = 0; k < work.nChunks; k++){
+    ch = &work.chunks[k];
+    pthread_mutex_lock(&work.lock);
+    while(!ch->done)
+      pthread_cond_wait(&work.chunkDone, &work.lock);
+    pthread_mutex_unlock(&work.lock);
+
+    // Find the last frame of the chunk
+    last = ch->nEv;
+    for(j = ch->nEv; j-- > 0;)
+      if(ch->ev[j].code > 0){
+        last = j;
+        break;
+      }
+
+    // Parse on until a frame matches one the worker found
+    synced = FALSE;
+    for(j = 0; j < ch->nEv && last < ch->nEv && !synced; j++){
+      off = ch->lo + ch->ev[j].off;
+      if(ch->ev[j].code <= 0 || off < pos)
+        continue;
+      end = off + ch->ev[j].code;
+      HostParseSpan(&fix, &work.cap[pos], end - pos);
+      pos = end;
+      synced = (stitch.lastFrame == off);
+    }
+
+    if(synced){
+      // Take the worker's results up to its last frame, or to the end of
+      // the capture for the final chunk
+      n = (k+1 < work.nChunks) ? last + 1 : ch->nEv;
+      for(; j < n; j++){
+        off = ch->lo + ch->ev[j].off;
+        if(ch->ev[j].code > 0)
+          OnFrame(t, off, &work.cap[off], ch->ev[j].code);
+        else
+          OnErr(t, off, (Error_t) ch->ev[j].code);
+      }
+      off = ch->lo + ch->ev[last].off;
+      pos = (k+1 < work.nChunks) ? off + ch->ev[last].code : size;
+      HostParserInit(&fix, pos, crc, OnStitchFrame, OnStitchErr, &stitch);
+    }
+
+    free(ch->ev);
+    ch->ev = NULL;
+  }
+  if(pos < size)
+    HostParseSpan(&fix, &work.cap[pos], size - pos);
+
+  for(i = 0; i < threads; i++)
+    pthread_join(tids[i], NULL);
+  free(tids);
+  free(work.chunks);
+  munmap((void *) work.cap, size);
+  return 0;
+}
+
+/*--------------- W o r k e r ---------------
+Decode chunks until there are none left. A chunk is parsed from its first
+plausible frame, and on past its end far enough to finish a frame that
+begins inside it.
+*/
+static void *Worker(void *arg){
+  Work *w = arg;
+  HostParser *hp = Grow(NULL, sizeof(HostParser));
+  CPU_INT64U start;
+  CPU_INT64U stop;
+  Chunk *ch;
+
+  for(;;){
+    pthread_mutex_lock(&w->lock);
+    ch = (w->next < w->nChunks) ? &w->chunks[w->next++] : NULL;
+    pthread_mutex_unlock(&w->lock);
+    if(ch == NULL)
+      break;
+
+    start = (ch->lo == 0) ? 0 : Resync(w->cap, ch->lo, ch->hi, w->size,
+                                       w->crc);
+    stop = ch->hi + MaxFrameLen;
+    if(stop > w->size)
+      stop = w->size;
+    HostParserInit(hp, start, w->crc, OnChunkFrame, OnChunkErr, ch);
+    if(start < stop)
+      HostParseSpan(hp, &w->cap[start], stop - start);
+
+    pthread_mutex_lock(&w->lock);
+    ch->done = TRUE;
+    pthread_cond_broadcast(&w->chunkDone);
+    pthread_mutex_unlock(&w->lock);
+  }
+
+  free(hp);
+  return NULL;
+}
+
+/*--------------- R e s y n c ---------------
+Return the offset of the first plausible frame in [lo, hi): a full
+preamble, a usable length that fits in the capture and a good checksum or
+CRC. Returns hi if there is none.
+*/
+static CPU_INT64U Resync(const CPU_INT08U *cap, CPU_INT64U lo,
+                         CPU_INT64U hi, CPU_INT64U size, CPU_BOOLEAN crc){
+  const CPU_INT08U *p;
+
+  for(; lo < hi; lo++){
+    p = memchr(&cap[lo], Preamble1, hi - lo);
+    if(p == NULL)
+      break;
+    lo = p - cap;
+    if(FrameCheck(p, (size - lo < MaxFrameLen) ? size - lo : MaxFrameLen, crc))
+      return lo;
+  }
+  return hi;
+}
+
+/*--------------- O n C h u n k F r a m e ---------------
+Record a frame that begins inside a worker's chunk. Only where it is and
+its length are kept; the stitching thread reads the frame from the
+mapping.
+*/
+static void OnChunkFrame(void *ctx, CPU_INT64U off, const CPU_INT08U *frame,
+                         CPU_INT16U len){
+  Chunk *ch = ctx;
+
+  (void) frame;
+  if(off < ch->hi)
+    AddEvent(ch, off, len);
+}
+
+/*--------------- O n C h u n k E r r ---------------
+Record an error found inside a worker's chunk.
+*/
+static void OnChunkErr(void *ctx, CPU_INT64U off, Error_t e){
+  Chunk *ch = ctx;
+
+  if(off < ch->hi)
+    AddEvent(ch, off, e);
+}
+
+/*--------------- A d d E v e n t ---------------
+Append an event to a chunk's list, growing it as needed.
+*/
+static void AddEvent(Chunk *ch, CPU_INT64U off, CPU_INT16S code){
+  if(ch->nEv == ch->maxEv){
+    ch->maxEv = ch->maxEv ? 2 * ch->maxEv : 4096;
+    ch->ev = Grow(ch->ev, ch->maxEv * sizeof(Event));
+  }
+  ch->ev[ch->nEv].off = (CPU_INT32U) (off - ch->lo);
+  ch->ev[ch->nEv].code = code;
+  ch->nEv++;
+}
+
+/*--------------- O n S t i t c h F r a m e ---------------
+Pass on a frame found by the stitching parser and note where it was.
+*/
+static void OnStitchFrame(void *ctx, CPU_INT64U off, const CPU_INT08U *frame,
+                          CPU_INT16U len){
+  Stitch *s = ctx;
+
+  s->lastFrame = off;
+  OnFrame(s->tally, off, frame, len);
+}
+
+/*--------------- O n S t i t c h E r r ---------------
+Pass on an error found by the stitching parser.
+*/
+static void OnStitchErr(void *ctx, CPU_INT64U off, Error_t e){
+  Stitch *s = ctx;
+
+  OnErr(s->tally, off, e);
+}
+
+/*--------------- O n F r a m e ---------------
+Count a good frame, and list it if asked to.
+*/
+static void OnFrame(void *ctx, CPU_INT64U off, const CPU_INT08U *frame,
+                    CPU_INT16U len){
+  Tally *t = ctx;
+
+  t->frames++;
+  t->types[frame[TypeOffset]]++;
+  if(t->analyze)
+    Gather(t, frame, len);
+  if(t->verbose)
+    printf("%10llu  dst %3u  src %3u  type %3u  len %3u\n",
+           (unsigned long long) off, frame[DstOffset], frame[SrcOffset],
+           frame[TypeOffset], len);
+}
+
+/*--------------- G a t h e r ---------------
+Add the fields of a reading to their columns. Readings too short for
+their fields are left out, as the payload task rejects them.
+*/
+static void Gather(Tally *t, const CPU_INT08U *frame, CPU_INT16U len){
+  const CPU_INT08U *d = &frame[DataOffset];
+  const MsgDef *m = MsgFind(frame[TypeOffset]);
+
+  if(m == NULL || len < DataOffset + m->minData + t->trailer)
+    return;
+  switch(m->type){
+    case(MSG_TIMESTAMP):
+      *(CPU_INT32U *) AddField(&t->stamps, sizeof(CPU_INT32U)) = MsgGet32(d);
+      break;
+    case(MSG_WIND):
+      memcpy(AddField(&t->speeds, BcdBytes), d + WindSpeedOffset, BcdBytes);
+      break;
+    case(MSG_PRECIPITATION):
+      memcpy(AddField(&t->depths, BcdBytes), d + PrecipDepthOffset, BcdBytes);
+      break;
+    default:
+      break;
+  }
+}
+
+/*--------------- A d d F i e l d ---------------
+Return room for one more field of size bytes at the end of a column,
+growing it as needed.
+*/
+static void *AddField(Column *c, size_t size){
+  if(c->n == c->max){
+    c->max = c->max ? 2 * c->max : 4096;
+    c->data = Grow(c->data, c->max * size);
+  }
+  return c->data + size * c->n++;
+}
+
+/*--------------- G r o w ---------------
+Return p reallocated to size bytes, or allocated if p is NULL. Exits if
+there is not the memory, as the decode cannot go on without the frames it
+would lose.
+*/
+static void *Grow(void *p, size_t size){
+  void *q = realloc(p, size);
+
+  if(q == NULL){
+    perror("realloc");
+    exit(1);
+  }
+  return q;
+}
+
+/*--------------- O n E r r ---------------
+Count an error, and list it if asked to.
+*/
+static void OnErr(void *ctx, CPU_INT64U off, Error_t e){
+  Tally *t = ctx;
+
+  t->errs[-e]++;
+  if(t->verbose)
+    printf("%10llu  error: %s\n", (unsigned long long) off, ErrNames[-e]);
+}
+
+/*--------------- R e p o r t ---------------
+Print the frame and error counts and the decode throughput.
+*/
+static void Report(const Tally *t, CPU_INT64U bytes, double secs){
+  int i;
+
+  printf("%llu bytes, %llu frames\n",
+         (unsigned long long) bytes, (unsigned long long) t->frames);
+  for(i = 0; i < NumMsgTypes; i++)
+    if(t->types[i])
+      printf("  type %3d: %llu\n", i, (unsigned long long) t->types[i]);
+  for(i = 1; i < NumErrs; i++)
+    if(t->errs[i])
+      printf("  %s errors: %llu\n", ErrNames[i], (unsigned long long) t->errs[i]);
+  if(secs > 0)
+    fprintf(stderr, "%.3f s, %.1f MB/s\n", secs, bytes / secs / 1e6);
+}
+
+/*--------------- A n a l y z e ---------------
+Decode the columns a batch at a time and print the time span of the good
+time stamps, how many were not dates, and the wind speed and
+precipitation totals.
+*/
+static void Analyze(const Tally *t){
+  static CPU_INT16U year[BatchSize];
+  static CPU_INT08U month[BatchSize];
+  static CPU_INT08U day[BatchSize];
+  static CPU_INT08U hour[BatchSize];
+  static CPU_INT08U min[BatchSize];
+  static CPU_INT64S secs[BatchSize];
+  const HostTimeCols cols = {year, month, day, hour, min};
+  const CPU_INT32U *stamps = (const CPU_INT32U *) t->stamps.data;
+  CPU_INT64S first = INT64_MAX;
+  CPU_INT64S last = INT64_MIN;
+  char from[TimeTextSize];
+  char to[TimeTextSize];
+  size_t bad = 0;
+  size_t i;
+  size_t j;
+  size_t n;
+
+  for(i = 0; i < t->stamps.n; i += n){
+    n = (t->stamps.n - i < BatchSize) ? t->stamps.n - i : BatchSize;
+    HostColsTime(stamps + i, n, &cols);
+    bad += HostColsEpoch(&cols, n, secs);
+    for(j = 0; j < n; j++){
+      if(secs[j] == HostColsBadTime)
+        continue;
+      if(secs[j] < first)
+        first = secs[j];
+      if(secs[j] > last)
+        last = secs[j];
+    }
+  }
+  printf("time stamps: %zu, %zu not a date", t->stamps.n, bad);
+  if(first <= last){
+    TimeText(first, from);
+    TimeText(last, to);
+    printf(", %s to %s", from, to);
+  }
+  printf("\n");
+
+  if(t->speeds.n)
+    printf("wind speed: %zu readings, mean %.1f\n", t->speeds.n,
+           SumBcd(&t->speeds) / 10.0 / t->speeds.n);
+  if(t->depths.n)
+    printf("precipitation: %zu readings, total %.2f\n", t->depths.n,
+           SumBcd(&t->depths) / 100.0);
+}
+
+/*--------------- S u m B c d ---------------
+Return the sum of the values of a column of 4 digit BCD readings
+*/
+static CPU_INT64U SumBcd(const Column *c){
+  static CPU_INT16U values[BatchSize];
+  CPU_INT64U sum = 0;
+  size_t i;
+  size_t j;
+  size_t n;
+
+  for(i = 0; i < c->n; i += n){
+    n = (c->n - i < BatchSize) ? c->n - i : BatchSize;
+    HostColsBcd(c->data + i * BcdBytes, n, values);
+    for(j = 0; j < n; j++)
+      sum += values[j];
+  }
+  return sum;
+}
+
+/*--------------- T i m e T e x t ---------------
+Write epoch seconds as YYYY-MM-DD HH:MM UTC
+*/
+static void TimeText(CPU_INT64S secs, char text[]){
+  time_t tt = (time_t) secs;
+  struct tm tm;
+
+  if(gmtime_r(&tt, &tm) == NULL)
+    snprintf(text, TimeTextSize, "%lld", (long long) secs);
+  else
+    strftime(text, TimeTextSize, "%Y-%m-%d %H:%M", &tm);
+}
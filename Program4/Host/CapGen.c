@@ -0,0 +1,224 @@
+/*--------------- C a p G e n . c ---------------
+
+by: Michael Nickelson
+
+PURPOSE
+Write a synthetic capture of sensor network traffic for exercising and
+timing the host decoder. Frames of every message type are generated with
+random contents, and a given percentage of them are damaged so that the
+error paths of the parser are exercised too.
+With -c frames end in a CRC-16 rather than the XOR checksum byte.
+With -v each field holds a value in its range, rather than random bytes,
+so every reading decodes. The fields of a time stamp hold a real date and
+time, with days up to the 28th so any month has them. Readings are laid
+out by MsgDefs.
+
+Build:  cc -O2 -I. -I../App -o CapGen CapGen.c ../App/FrameChk.c \
+                          ../App/MsgDefs.c
+Usage:  CapGen [-n frames] [-e percent] [-s seed] [-c] [-v] capture
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Frame layout and checksum come from FrameChk
+10-19-2026 mn -  Added -c for CRC-16 framing
+10-19-2026 mn -  Message types and lengths come from MsgDefs, added -v for
+                 valid field values
+10-19-2026 mn -  -v time stamps hold a real date and time
+*/
+
+#include "includes.h"
+#include <unistd.h>
+#include "FrameChk.h"
+#include "MsgDefs.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define NumNodes 4        /* Destinations are drawn from 1..NumNodes */
+#define MaxFields 8
+#define IdFirst ' '       /* Printable characters for ID fields */
+#define IdChars ('~' - ' ' + 1)
+#define Months 12         /* Ranges of the time stamp fields for -v */
+#define Days 28           /* Every month has them */
+#define Hours 24
+#define Mins 60
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+/* The sensor readings */
+#define MSG_PTR(constant, type, Name, key, minData, maxData) &Name##Def,
+static const MsgDef *const Msgs[] = {MSG_LIST(MSG_PTR)};
+#undef MSG_PTR
+#define NumMsgs (sizeof(Msgs) / sizeof(Msgs[0]))
+
+/*----- l o c a l   f u n c t i o n    p r o t o t y p e s -----*/
+static CPU_INT16U MakeFrame(CPU_INT08U *frame, CPU_BOOLEAN crc,
+                            CPU_BOOLEAN valid);
+static CPU_INT08U ValidData(const MsgDef *m, CPU_INT08U *data);
+static CPU_INT32S FieldValue(const MsgField *f);
+static void Damage(CPU_INT08U *frame, CPU_INT16U len);
+
+/*--------------- m a i n ( ) -----------------*/
+int main(int argc, char *argv[]){
+  CPU_INT08U frame[MaxFrameLen];
+  unsigned long frames = 1000000;
+  unsigned errPct = 0;
+  CPU_BOOLEAN crc = FALSE;
+  CPU_BOOLEAN valid = FALSE;
+  unsigned long i;
+  CPU_INT16U len;
+  FILE *f;
+  int opt;
+
+  srand(1);
+  while((opt = getopt(argc, argv, "n:e:s:cv")) != -1){
+    switch(opt){
+      case 'n':
+        frames = strtoul(optarg, NULL, 0);
+        break;
+      case 'e':
+        errPct = strtoul(optarg, NULL, 0);
+        break;
+      case 's':
+        srand(strtoul(optarg, NULL, 0));
+        break;
+      case 'c':
+        crc = TRUE;
+        break;
+      case 'v':
+        valid = TRUE;
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-n frames] [-e percent] [-s seed] [-c] [-v] capture\n",
+                argv[0]);
+        return 2;
+    }
+  }
+  if(optind >= argc){
+    fprintf(stderr, "usage: %s [-n frames] [-e percent] [-s seed] [-c] [-v] capture\n",
+            argv[0]);
+    return 2;
+  }
+
+  f = fopen(argv[optind], "wb");
+  if(f == NULL){
+    perror(argv[optind]);
+    return 1;
+  }
+  for(i = 0; i < frames; i++){
+    len = MakeFrame(frame, crc, valid);
+    if((unsigned) (rand() % 100) < errPct)
+      Damage(frame, len);
+    fwrite(frame, 1, len, f);
+  }
+  fclose(f);
+  return 0;
+}
+
+/*--------------- M a k e F r a m e ---------------
+Build one good frame of a random message type and return its length.
+crc selects a CRC-16 trailer over the checksum byte. valid fills the
+fields with values in their ranges rather than random bytes.
+*/
+static CPU_INT16U MakeFrame(CPU_INT08U *frame, CPU_BOOLEAN crc,
+                            CPU_BOOLEAN valid){
+  const MsgDef *m = Msgs[rand() % NumMsgs];
+  // Fixed size readings at their size, the ID at its longest
+  CPU_INT08U dataLen = (m->maxData < MsgOpen) ? m->maxData : m->minData;
+  CPU_INT16U len = HeaderLength + MinBodyLength + dataLen +
+                   (crc ? CrcLength : ChkLength);
+  CPU_INT16U chk;
+  CPU_INT16U i;
+
+  frame[0] = Preamble1;
+  frame[1] = Preamble2;
+  frame[2] = Preamble3;
+  frame[3] = len;
+  frame[4] = 1 + rand() % NumNodes;   // Destination
+  frame[5] = rand();                  // Source
+  frame[6] = m->type;
+  if(valid)
+    ValidData(m, &frame[7]);
+  if(crc){
+    for(i = 7; i < len-CrcLength && !valid; i++)
+      frame[i] = rand();
+    chk = FrameCrc16(CrcInit, frame, len-CrcLength);
+    frame[len-2] = chk >> 8;
+    frame[len-1] = chk & 0xFF;
+  }else{
+    for(i = 7; i < len-ChkLength && !valid; i++)
+      frame[i] = rand();
+    frame[len-1] = FrameXor(frame, len-1);
+  }
+
+  return len;
+}
+
+/*--------------- V a l i d D a t a ---------------
+Write the data part of a reading of message m with a random value in
+range in each field, and return its length
+*/
+static CPU_INT08U ValidData(const MsgDef *m, CPU_INT08U *data){
+  CPU_INT32S values[MaxFields];
+  const MsgField *f;
+  CPU_INT08U len;
+  CPU_INT08U i;
+  CPU_INT08U n;
+
+  for(i = 0; i < m->numFields; i++)
+    values[i] = FieldValue(&m->fields[i]);
+  len = MsgEncode(m, data, values);
+  // Strings run to the end of the data part
+  for(i = 0; i < m->numFields; i++){
+    f = &m->fields[i];
+    if(f->kind != FLD_STR)
+      continue;
+    for(n = 0; n < f->a; n++)
+      data[f->offset + n] = IdFirst + rand() % IdChars;
+    len = f->offset + f->a;
+  }
+
+  return len;
+}
+
+/*--------------- F i e l d V a l u e ---------------
+Return a random value in the range of a numeric field. The fields of a
+time stamp, told apart by their positions, stay in calendar range; the
+year may be any the field holds.
+*/
+static CPU_INT32S FieldValue(const MsgField *f){
+  CPU_INT32S top = 1;
+  CPU_INT08U d;
+
+  switch(f->kind){
+    case(FLD_S8):
+      return (CPU_INT08S) rand();
+    case(FLD_U8):
+      return rand() & 0xFF;
+    case(FLD_U16):
+      return rand() & 0xFFFF;
+    case(FLD_BCD):
+      for(d = 0; d < f->a; d++)
+        top *= 10;
+      return rand() % top;
+    case(FLD_BITS):
+      switch(f->a){
+        case(MonthPosition):
+          return 1 + rand() % Months;
+        case(DayPosition):
+          return 1 + rand() % Days;
+        case(HourPosition):
+          return rand() % Hours;
+        case(MinutePosition):
+          return rand() % Mins;
+        default:
+          return rand() % (f->b + 1);
+      }
+    default:
+      return 0;
+  }
+}
+
+/*--------------- D a m a g e ---------------
+Flip a bit of a random byte, as RF noise would.
+*/
+static void Damage(CPU_INT08U *frame, CPU_INT16U len){
+  frame[rand() % len] ^= 1 << (rand() % 8);
+}
@@ -0,0 +1,156 @@
+/*--------------- C h k B e n c h . c ---------------
+
+by: Michael Nickelson
+
+PURPOSE
+Microbenchmark for the frame validation kernels in FrameChk.c.
+Each variant is run over blocks of typical frame sizes and over one large
+block, and the time per byte is printed. On x86 the time stamp counter
+cycles per byte are printed too. The variants are checked against each
+other before they are timed.
+
+Build:  cc -O2 -I. -I../App -o ChkBench ChkBench.c Bench.c \
+                          ../App/FrameChk.c
+Usage:  ChkBench
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Added the CRC-16 kernels and cycle counts
+10-19-2026 mn -  Clock, cycle count and sink from Bench.h
+*/
+
+#include "includes.h"
+#include "Bench.h"
+#include "FrameChk.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define BenchBytes (256UL << 20)  /* Bytes reduced per timing */
+#define LargeBlock (1UL << 20)
+
+/*----- t y p e d e f s   u s e d   b y   t h e   b e n c h m a r k -----*/
+typedef CPU_INT32U (*KernelFn)(const CPU_INT08U *p, CPU_INT32U n);
+
+typedef struct{
+  const char *name;
+  KernelFn fn;
+  KernelFn ref;             // Variant it must agree with
+} Variant;
+
+typedef struct{
+  double ns;                // Per byte
+  double cycles;
+} Timing;
+
+/*----- l o c a l   f u n c t i o n    p r o t o t y p e s -----*/
+static CPU_INT32U XorBytes(const CPU_INT08U *p, CPU_INT32U n);
+static CPU_INT32U XorWords(const CPU_INT08U *p, CPU_INT32U n);
+static CPU_INT32U XorVector(const CPU_INT08U *p, CPU_INT32U n);
+static CPU_INT32U CrcTable(const CPU_INT08U *p, CPU_INT32U n);
+static CPU_INT32U CrcSlice(const CPU_INT08U *p, CPU_INT32U n);
+static Timing TimeKernel(KernelFn fn, const CPU_INT08U *bfr, CPU_INT32U size);
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+static const Variant Variants[] = {{"xor byte", XorBytes, XorBytes},
+                                   {"xor word", XorWords, XorBytes},
+                                   {"xor vec", XorVector, XorBytes},
+                                   {"crc tbl", CrcTable, CrcTable},
+                                   {"crc sl8", CrcSlice, CrcTable}};
+static const CPU_INT32U Sizes[] = {9, 12, 18, 64, MaxFrameLen, LargeBlock};
+
+/*--------------- m a i n ( ) -----------------*/
+int main(void){
+  const int NumVariants = sizeof(Variants) / sizeof(Variants[0]);
+  const int NumSizes = sizeof(Sizes) / sizeof(Sizes[0]);
+  CPU_INT08U *bfr = malloc(LargeBlock + 1);
+  Timing t[sizeof(Variants) / sizeof(Variants[0])];
+  CPU_INT32U n;
+  CPU_INT32U i;
+  int v;
+  int s;
+
+  FrameCrc16Init();
+  for(i = 0; i <= LargeBlock; i++)
+    bfr[i] = rand();
+
+  // Every variant must agree with its reference at every length and
+  // alignment
+  for(n = 0; n < 2 * MaxFrameLen; n++)
+    for(v = 0; v < NumVariants; v++)
+      if(Variants[v].fn(bfr + 1, n) != Variants[v].ref(bfr + 1, n) ||
+         Variants[v].fn(bfr, n) != Variants[v].ref(bfr, n)){
+        printf("%s disagrees at length %u\n", Variants[v].name, n);
+        return 1;
+      }
+  // CRC of "123456789" is the published check value for CRC-16/CCITT-FALSE
+  if(CrcTable((const CPU_INT08U *) "123456789", 9) != 0x29B1){
+    printf("crc check value wrong\n");
+    return 1;
+  }
+
+  printf("%-8s", "bytes");
+  for(v = 0; v < NumVariants; v++)
+    printf("%10s", Variants[v].name);
+  printf("   (ns/byte, cycles/byte)\n");
+  for(s = 0; s < NumSizes; s++){
+    for(v = 0; v < NumVariants; v++)
+      t[v] = TimeKernel(Variants[v].fn, bfr, Sizes[s]);
+    printf("%-8u", Sizes[s]);
+    for(v = 0; v < NumVariants; v++)
+      printf("%10.3f", t[v].ns);
+    printf("\n%-8s", "");
+    for(v = 0; v < NumVariants; v++)
+      printf("%10.2f", t[v].cycles);
+    printf("\n");
+  }
+
+  free(bfr);
+  return 0;
+}
+
+/*--------------- T i m e K e r n e l ---------------
+Return the time and cycles per byte of running a kernel over BenchBytes
+bytes in blocks of size.
+*/
+static Timing TimeKernel(KernelFn fn, const CPU_INT08U *bfr, CPU_INT32U size){
+  CPU_INT32U reps = BenchBytes / size;
+  CPU_INT32U off = 0;
+  CPU_INT32U x = 0;
+  CPU_INT64U c0;
+  double start;
+  Timing t;
+  CPU_INT32U i;
+
+  start = BenchNow();
+  c0 = BenchCycles();
+  for(i = 0; i < reps; i++){
+    x ^= fn(bfr + off, size);
+    // Walk through the buffer so frames land at every alignment
+    off = (off + size) % (LargeBlock - size + 1);
+  }
+  t.cycles = (double) (BenchCycles() - c0) / ((double) reps * size);
+  t.ns = (BenchNow() - start) * 1e9 / ((double) reps * size);
+  benchSink = x;
+
+  return t;
+}
+
+/* Kernels wrapped to a common type */
+static CPU_INT32U XorBytes(const CPU_INT08U *p, CPU_INT32U n){
+  return FrameXorBytes(p, n);
+}
+
+static CPU_INT32U XorWords(const CPU_INT08U *p, CPU_INT32U n){
+  return FrameXorWords(p, n);
+}
+
+static CPU_INT32U XorVector(const CPU_INT08U *p, CPU_INT32U n){
+  return FrameXorVector(p, n);
+}
+
+static CPU_INT32U CrcTable(const CPU_INT08U *p, CPU_INT32U n){
+  return FrameCrc16(CrcInit, p, n);
+}
+
+static CPU_INT32U CrcSlice(const CPU_INT08U *p, CPU_INT32U n){
+  return FrameCrc16Slice8(CrcInit, p, n);
+}
@@ -0,0 +1,266 @@
+/*--------------- C o l B e n c h . c ---------------
+
+by: Michael Nickelson
+
+PURPOSE
+Benchmark for the batch kernels in HostCols.c. Date/time stamps and BCD
+readings are decoded three ways and the records per second printed:
+  row      one record at a time with the MsgDefs accessors, as the payload
+           task's text replies do
+  column   the scalar column kernels
+  sse2     the SSE2 column kernels, where built
+Time stamps are timed split into fields alone and split then converted to
+epoch seconds. The row decoder reads the big endian wire bytes; the column
+kernels take the words already gathered, as CapDecode gathers them. The
+ways are checked against each other before they are timed.
+
+Build:  cc -O2 -I. -I../App -o ColBench ColBench.c Bench.c HostCols.c \
+                          ../App/MsgDefs.c
+Usage:  ColBench [records]
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Clock, cycle count and sink from Bench.h
+*/
+
+#include "includes.h"
+#include "Bench.h"
+#include "HostCols.h"
+#include "MsgDefs.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define DefaultRecords (1UL << 20)
+#define BenchRecords (64UL << 20)   /* Records decoded per timing */
+#define TimeBytes 4
+#define BcdBytes 2
+#define FirstYear 1990
+#define Years 60
+
+/*----- t y p e d e f s   u s e d   b y   t h e   b e n c h m a r k -----*/
+/* Columns and wire copies of every record */
+typedef struct{
+  size_t n;
+  CPU_INT08U *timeWire;     // Big endian, as in packets
+  CPU_INT32U *packed;       // Gathered
+  HostTimeCols cols;
+  CPU_INT64S *secs;
+  CPU_INT08U *bcd;
+  CPU_INT16U *values;
+} Records;
+
+typedef void (*PassFn)(Records *r);
+
+/*----- l o c a l   f u n c t i o n    p r o t o t y p e s -----*/
+static void MakeRecords(Records *r, size_t n);
+static void RowSplit(Records *r);
+static void RowEpoch(Records *r);
+static void ColSplit(Records *r);
+static void ColEpoch(Records *r);
+static void SseSplit(Records *r);
+static void SseEpoch(Records *r);
+static void RowBcd(Records *r);
+static void ColBcd(Records *r);
+static void SseBcd(Records *r);
+static CPU_BOOLEAN Agree(Records *r, PassFn ref, PassFn fn);
+static double RecordsPerSec(Records *r, PassFn fn);
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+static const struct{
+  const char *name;
+  PassFn row;
+  PassFn col;
+  PassFn sse;
+} Tests[] = {{"time split", RowSplit, ColSplit, SseSplit},
+             {"time epoch", RowEpoch, ColEpoch, SseEpoch},
+             {"bcd", RowBcd, ColBcd, SseBcd}};
+
+/*--------------- m a i n ( ) -----------------*/
+int main(int argc, char *argv[]){
+  const int NumTests = sizeof(Tests) / sizeof(Tests[0]);
+  static Records r;
+  size_t n = DefaultRecords;
+  int i;
+
+  if(argc > 1)
+    n = strtoul(argv[1], NULL, 0);
+  HostColsInit();
+  MakeRecords(&r, n);
+
+  for(i = 0; i < NumTests; i++)
+    if(!Agree(&r, Tests[i].row, Tests[i].col) ||
+       !Agree(&r, Tests[i].row, Tests[i].sse)){
+      printf("%s disagrees\n", Tests[i].name);
+      return 1;
+    }
+
+  printf("%-12s%12s%12s%12s   (M records/s, %lu records)\n", "", "row",
+         "column",
+#if defined(__SSE2__)
+         "sse2",
+#else
+         "-",
+#endif
+         (unsigned long) n);
+  for(i = 0; i < NumTests; i++)
+    printf("%-12s%12.1f%12.1f%12.1f\n", Tests[i].name,
+           RecordsPerSec(&r, Tests[i].row) / 1e6,
+           RecordsPerSec(&r, Tests[i].col) / 1e6,
+           RecordsPerSec(&r, Tests[i].sse) / 1e6);
+
+  return 0;
+}
+
+/*--------------- M a k e R e c o r d s ---------------
+Fill n records with time stamps of recent years, one in a hundred of them
+not a date, and BCD readings with good digits
+*/
+static void MakeRecords(Records *r, size_t n){
+  CPU_INT32U w;
+  CPU_INT16U v;
+  size_t i;
+
+  r->n = n;
+  r->timeWire = malloc(n * TimeBytes);
+  r->packed = malloc(n * sizeof(CPU_INT32U));
+  r->cols.year = malloc(n * sizeof(CPU_INT16U));
+  r->cols.month = malloc(n);
+  r->cols.day = malloc(n);
+  r->cols.hour = malloc(n);
+  r->cols.min = malloc(n);
+  r->secs = malloc(n * sizeof(CPU_INT64S));
+  r->bcd = malloc(n * BcdBytes);
+  r->values = malloc(n * sizeof(CPU_INT16U));
+
+  for(i = 0; i < n; i++){
+    w = (CPU_INT32U) (FirstYear + rand() % Years) << YearPosition |
+        (CPU_INT32U) (1 + rand() % 12) << MonthPosition |
+        (CPU_INT32U) (1 + rand() % 28) << DayPosition |
+        (CPU_INT32U) (rand() % 24) << HourPosition |
+        (CPU_INT32U) (rand() % 60) << MinutePosition;
+    if(rand() % 100 == 0)
+      w = rand();
+    EndianPut32BE(r->timeWire + i * TimeBytes, w);
+    r->packed[i] = w;
+
+    v = rand() % 10000;
+    r->bcd[i * BcdBytes] = (v / 1000) << 4 | (v / 100 % 10);
+    r->bcd[i * BcdBytes + 1] = (v / 10 % 10) << 4 | (v % 10);
+  }
+}
+
+/* Passes over all the records. Row passes decode each record in place. */
+static void RowSplit(Records *r){
+  const CPU_INT08U *d;
+  size_t i;
+
+  for(i = 0; i < r->n; i++){
+    d = r->timeWire + i * TimeBytes;
+    r->cols.year[i] = GetTimeStampYear(d);
+    r->cols.month[i] = GetTimeStampMonth(d);
+    r->cols.day[i] = GetTimeStampDay(d);
+    r->cols.hour[i] = GetTimeStampHour(d);
+    r->cols.min[i] = GetTimeStampMin(d);
+  }
+}
+
+static void RowEpoch(Records *r){
+  HostTimeCols one;
+  size_t i;
+
+  RowSplit(r);
+  for(i = 0; i < r->n; i++){
+    one.year = r->cols.year + i;
+    one.month = r->cols.month + i;
+    one.day = r->cols.day + i;
+    one.hour = r->cols.hour + i;
+    one.min = r->cols.min + i;
+    HostColsEpoch(&one, 1, &r->secs[i]);
+  }
+}
+
+static void ColSplit(Records *r){
+  HostColsTimeScalar(r->packed, r->n, &r->cols);
+}
+
+static void ColEpoch(Records *r){
+  HostColsTimeScalar(r->packed, r->n, &r->cols);
+  HostColsEpoch(&r->cols, r->n, r->secs);
+}
+
+static void SseSplit(Records *r){
+  HostColsTime(r->packed, r->n, &r->cols);
+}
+
+static void SseEpoch(Records *r){
+  HostColsTime(r->packed, r->n, &r->cols);
+  HostColsEpoch(&r->cols, r->n, r->secs);
+}
+
+static void RowBcd(Records *r){
+  size_t i;
+
+  for(i = 0; i < r->n; i++)
+    r->values[i] = MsgBcd(r->bcd + i * BcdBytes, PrecipDigits);
+}
+
+static void ColBcd(Records *r){
+  HostColsBcdScalar(r->bcd, r->n, r->values);
+}
+
+static void SseBcd(Records *r){
+  HostColsBcd(r->bcd, r->n, r->values);
+}
+
+/*--------------- A g r e e ---------------
+Return TRUE if a pass writes the same columns as its reference
+*/
+static CPU_BOOLEAN Agree(Records *r, PassFn ref, PassFn fn){
+  size_t n = r->n;
+  CPU_INT16U *year = malloc(n * sizeof(CPU_INT16U));
+  CPU_INT08U *fields = malloc(4 * n);
+  CPU_INT64S *secs = malloc(n * sizeof(CPU_INT64S));
+  CPU_INT16U *values = malloc(n * sizeof(CPU_INT16U));
+  CPU_BOOLEAN same;
+
+  memset(r->secs, 0, n * sizeof(CPU_INT64S));
+  ref(r);
+  memcpy(year, r->cols.year, n * sizeof(CPU_INT16U));
+  memcpy(fields, r->cols.month, n);
+  memcpy(fields + n, r->cols.day, n);
+  memcpy(fields + 2*n, r->cols.hour, n);
+  memcpy(fields + 3*n, r->cols.min, n);
+  memcpy(secs, r->secs, n * sizeof(CPU_INT64S));
+  memcpy(values, r->values, n * sizeof(CPU_INT16U));
+
+  memset(r->secs, 0, n * sizeof(CPU_INT64S));
+  fn(r);
+  same = memcmp(year, r->cols.year, n * sizeof(CPU_INT16U)) == 0 &&
+         memcmp(fields, r->cols.month, n) == 0 &&
+         memcmp(fields + n, r->cols.day, n) == 0 &&
+         memcmp(fields + 2*n, r->cols.hour, n) == 0 &&
+         memcmp(fields + 3*n, r->cols.min, n) == 0 &&
+         memcmp(secs, r->secs, n * sizeof(CPU_INT64S)) == 0 &&
+         memcmp(values, r->values, n * sizeof(CPU_INT16U)) == 0;
+
+  free(year);
+  free(fields);
+  free(secs);
+  free(values);
+  return same;
+}
+
+/*--------------- R e c o r d s P e r S e c ---------------
+Return the records a second a pass decodes, over at least BenchRecords
+*/
+static double RecordsPerSec(Records *r, PassFn fn){
+  size_t reps = BenchRecords / r->n + 1;
+  double start;
+  size_t i;
+
+  start = BenchNow();
+  for(i = 0; i < reps; i++)
+    fn(r);
+  benchSink = r->secs[r->n - 1] + r->values[r->n - 1];
+
+  return (double) reps * r->n / (BenchNow() - start);
+}
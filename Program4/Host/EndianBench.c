@@ -0,0 +1,222 @@
+/*--------------- E n d i a n B e n c h . c ---------------
+
+by: Michael Nickelson
+
+PURPOSE
+Microbenchmark for the field accessors in Endian.h against the byte at a
+time code they replace. Each variant reads big endian fields at odd
+offsets, as they sit in payload records, and the time and cycles per
+field are printed. The variants are checked against each other before
+they are timed.
+The one field readers Get16*, Get32* and Put32LE* are kept out of line so
+their code can be read with
+  objdump -d --no-show-raw-insn EndianBench | sed -n '/<Get32Endian>:/,/ret/p'
+On x86 the Endian versions are a load and BSWAP or ROL, or one MOVBE with
+-march=native. On Cortex-M3 they are LDR then REV, LDRH then REV16, and
+STR. GCC may match the byte versions to the same code when a field is
+read alone, but not inside the kernels' loops, and the timings show it.
+
+Build:  cc -O2 -I. -I../App -o EndianBench EndianBench.c Bench.c
+Usage:  EndianBench
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Clock, cycle count and sink from Bench.h
+*/
+
+#include "includes.h"
+#include "Bench.h"
+#include "Endian.h"
+
+#define NoInline __attribute__((noinline))
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define BfrBytes 4096
+#define Stride 7                /* Odd, so fields land at every alignment */
+#define NumFields ((BfrBytes - sizeof(CPU_INT32U)) / Stride)
+#define Reps 100000
+
+/*----- t y p e d e f s   u s e d   b y   t h e   b e n c h m a r k -----*/
+typedef CPU_INT32U (*KernelFn)(const CPU_INT08U *p);
+
+typedef struct{
+  const char *name;
+  KernelFn fn;
+  KernelFn ref;             // Variant it must agree with
+} Variant;
+
+typedef struct{
+  double ns;                // Per field
+  double cycles;
+} Timing;
+
+/*----- l o c a l   f u n c t i o n    p r o t o t y p e s -----*/
+CPU_INT16U Get16Bytes(const CPU_INT08U *p);
+CPU_INT16U Get16Endian(const CPU_INT08U *p);
+CPU_INT32U Get32Bytes(const CPU_INT08U *p);
+CPU_INT32U Get32Endian(const CPU_INT08U *p);
+void Put32LEBytes(CPU_INT08U *p, CPU_INT32U v);
+void Put32LEEndian(CPU_INT08U *p, CPU_INT32U v);
+static CPU_INT32U Sum16Bytes(const CPU_INT08U *p);
+static CPU_INT32U Sum16Endian(const CPU_INT08U *p);
+static CPU_INT32U Sum32Bytes(const CPU_INT08U *p);
+static CPU_INT32U Sum32Endian(const CPU_INT08U *p);
+static CPU_INT32U Copy32Bytes(const CPU_INT08U *p);
+static CPU_INT32U Copy32Endian(const CPU_INT08U *p);
+static Timing TimeKernel(KernelFn fn, const CPU_INT08U *bfr);
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+static const Variant Variants[] = {{"be16 byte", Sum16Bytes, Sum16Bytes},
+                                   {"be16 end", Sum16Endian, Sum16Bytes},
+                                   {"be32 byte", Sum32Bytes, Sum32Bytes},
+                                   {"be32 end", Sum32Endian, Sum32Bytes},
+                                   {"le32 byte", Copy32Bytes, Copy32Bytes},
+                                   {"le32 end", Copy32Endian, Copy32Bytes}};
+static CPU_INT08U out[BfrBytes];
+
+/*--------------- m a i n ( ) -----------------*/
+int main(void){
+  const int NumVariants = sizeof(Variants) / sizeof(Variants[0]);
+  static CPU_INT08U bfr[BfrBytes];
+  Timing t;
+  CPU_INT32U i;
+  int v;
+
+  for(i = 0; i < BfrBytes; i++)
+    bfr[i] = rand();
+
+  // Every variant must agree with its reference, at both buffer parities
+  for(v = 0; v < NumVariants; v++)
+    if(Variants[v].fn(bfr) != Variants[v].ref(bfr) ||
+       Variants[v].fn(bfr + 1) != Variants[v].ref(bfr + 1)){
+      printf("%s disagrees\n", Variants[v].name);
+      return 1;
+    }
+  if(Get16Endian(bfr + 1) != Get16Bytes(bfr + 1) ||
+     Get32Endian(bfr + 1) != Get32Bytes(bfr + 1)){
+    printf("field readers disagree\n");
+    return 1;
+  }
+
+  printf("%-10s%10s%10s\n", "variant", "ns/field", "cyc/field");
+  for(v = 0; v < NumVariants; v++){
+    t = TimeKernel(Variants[v].fn, bfr);
+    printf("%-10s%10.3f%10.2f\n", Variants[v].name, t.ns, t.cycles);
+  }
+
+  return 0;
+}
+
+/*--------------- T i m e K e r n e l ---------------
+Return the time and cycles per field of running a kernel Reps times
+*/
+static Timing TimeKernel(KernelFn fn, const CPU_INT08U *bfr){
+  CPU_INT32U x = 0;
+  CPU_INT64U c0;
+  double start;
+  Timing t;
+  CPU_INT32U i;
+
+  start = BenchNow();
+  c0 = BenchCycles();
+  for(i = 0; i < Reps; i++)
+    x += fn(bfr + (i & 1));
+  t.cycles = (double) (BenchCycles() - c0) / ((double) Reps * NumFields);
+  t.ns = (BenchNow() - start) * 1e9 / ((double) Reps * NumFields);
+  benchSink = x;
+
+  return t;
+}
+
+/* One field, out of line for reading the code */
+NoInline CPU_INT16U Get16Bytes(const CPU_INT08U *p){
+  return (CPU_INT16U) (p[0] << 8 | p[1]);
+}
+
+NoInline CPU_INT16U Get16Endian(const CPU_INT08U *p){
+  return EndianGet16BE(p);
+}
+
+NoInline CPU_INT32U Get32Bytes(const CPU_INT08U *p){
+  return (CPU_INT32U) p[0] << 24 | (CPU_INT32U) p[1] << 16 |
+         (CPU_INT32U) p[2] << 8 | p[3];
+}
+
+NoInline CPU_INT32U Get32Endian(const CPU_INT08U *p){
+  return EndianGet32BE(p);
+}
+
+NoInline void Put32LEBytes(CPU_INT08U *p, CPU_INT32U v){
+  p[0] = v;
+  p[1] = v >> 8;
+  p[2] = v >> 16;
+  p[3] = v >> 24;
+}
+
+NoInline void Put32LEEndian(CPU_INT08U *p, CPU_INT32U v){
+  EndianPut32LE(p, v);
+}
+
+/* Kernels over every field of the buffer */
+static CPU_INT32U Sum16Bytes(const CPU_INT08U *p){
+  CPU_INT32U x = 0;
+  CPU_INT32U i;
+
+  for(i = 0; i < NumFields; i++)
+    x += (CPU_INT16U) (p[i * Stride] << 8 | p[i * Stride + 1]);
+  return x;
+}
+
+static CPU_INT32U Sum16Endian(const CPU_INT08U *p){
+  CPU_INT32U x = 0;
+  CPU_INT32U i;
+
+  for(i = 0; i < NumFields; i++)
+    x += EndianGet16BE(p + i * Stride);
+  return x;
+}
+
+static CPU_INT32U Sum32Bytes(const CPU_INT08U *p){
+  CPU_INT32U x = 0;
+  CPU_INT32U i;
+
+  for(i = 0; i < NumFields; i++)
+    x ^= (CPU_INT32U) p[i * Stride] << 24 |
+         (CPU_INT32U) p[i * Stride + 1] << 16 |
+         (CPU_INT32U) p[i * Stride + 2] << 8 | p[i * Stride + 3];
+  return x;
+}
+
+static CPU_INT32U Sum32Endian(const CPU_INT08U *p){
+  CPU_INT32U x = 0;
+  CPU_INT32U i;
+
+  for(i = 0; i < NumFields; i++)
+    x ^= EndianGet32BE(p + i * Stride);
+  return x;
+}
+
+// Big endian fields rewritten little endian, as in binary replies
+static CPU_INT32U Copy32Bytes(const CPU_INT08U *p){
+  CPU_INT32U v;
+  CPU_INT32U i;
+
+  for(i = 0; i < NumFields; i++){
+    v = (CPU_INT32U) p[i * Stride] << 24 |
+        (CPU_INT32U) p[i * Stride + 1] << 16 |
+        (CPU_INT32U) p[i * Stride + 2] << 8 | p[i * Stride + 3];
+    out[i * Stride + 1] = v;
+    out[i * Stride + 2] = v >> 8;
+    out[i * Stride + 3] = v >> 16;
+    out[i * Stride + 4] = v >> 24;
+  }
+  return EndianGet32LE(out + 1);
+}
+
+static CPU_INT32U Copy32Endian(const CPU_INT08U *p){
+  CPU_INT32U i;
+
+  for(i = 0; i < NumFields; i++)
+    EndianPut32LE(out + i * Stride + 1, EndianGet32BE(p + i * Stride));
+  return EndianGet32LE(out + 1);
+}
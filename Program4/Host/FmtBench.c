@@ -0,0 +1,285 @@
+/*--------------- F m t B e n c h . c ---------------
+
+by: Michael Nickelson
+
+PURPOSE
+Microbenchmark for the text replies built with Fmt.c.
+Random payload records of each sensor message type are replied to twice:
+by the payload task's own TextReply, compiled in from Payload.c, and by
+a reference that decodes the same wire bytes and formats them with the
+sprintf formats Payload.c had before Fmt. The two must match byte for
+byte before anything is timed. The time per reply is then printed, and on
+x86 the time stamp counter cycles per reply too. The tasks the payload
+task talks to are stubbed out here, and HostOS.c stands in for the O/S.
+Stack use per function comes from building with -fstack-usage and reading
+the .su files.
+
+Build:  cc -O2 -I. -I../App -o FmtBench FmtBench.c Bench.c HostOS.c \
+                          ../App/Payload.c ../App/Fmt.c ../App/MsgDefs.c \
+                          ../App/AddrMap.c ../App/Error.c ../App/NodeCache.c \
+                          ../App/Clock.c ../App/BfrPair.c ../App/Buffer.c \
+                          ../App/FrameChk.c
+Usage:  FmtBench
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Times the real TextReply of Payload.c rather than a copy
+10-19-2026 mn -  Constant messages returned by TextReply are copied out
+10-19-2026 mn -  Clock, cycle count and sink from Bench.h
+*/
+
+#include "includes.h"
+#include "Bench.h"
+#include "AddrMap.h"
+#include "MsgDefs.h"
+#include "Payload.h"
+#include "PktParser.h"
+#include "ReplyQ.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define BenchReplies 2000000UL  /* Replies built per timing */
+#define CheckReplies 100000UL   /* Random replies compared before timing */
+#define NumReadings 8           /* Sensor message types, 1 to 8 */
+#define ReplySize 128
+
+/*----- t y p e d e f s   u s e d   b y   t h e   b e n c h m a r k -----*/
+typedef CPU_CHAR *(*FormatFn)(Payload *payload, CPU_CHAR reply[]);
+
+typedef struct{
+  double ns;                // Per reply
+  double cycles;
+} Timing;
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+/* From Payload.c */
+CPU_CHAR *TextReply(Payload *payload, CPU_CHAR reply[], const Msg_t **msg);
+
+/*----- l o c a l   f u n c t i o n    p r o t o t y p e s -----*/
+static CPU_CHAR *FormatSprintf(Payload *payload, CPU_CHAR reply[]);
+static CPU_CHAR *FormatFmt(Payload *payload, CPU_CHAR reply[]);
+static void RandomRecord(Payload *payload, CPU_INT08U msgType);
+static Timing TimeFormat(FormatFn fn, Payload *payloads, CPU_INT32U n);
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+static const char *TypeNames[NumReadings + 1] = {"", "temp", "pres", "hum",
+                                                 "wind", "rad", "time",
+                                                 "precip", "id"};
+
+/* The payload task's semaphores, defined by the parser */
+OS_SEM openPayloadBfrs;
+OS_SEM closedPayloadBfrs;
+
+/*--------------- m a i n ( ) -----------------*/
+int main(void){
+  static Payload p[NumReadings + 1];
+  CPU_CHAR a[ReplySize];
+  CPU_CHAR b[ReplySize];
+  Timing ts;
+  Timing tf;
+  CPU_INT32U i;
+  CPU_INT08U t;
+
+  AddrMapInit();
+  CreatePayloadTask();
+
+  srand(1);
+  // Include nibbles over 9 and extreme values, which Fmt must also match
+  for(i = 0; i < CheckReplies; i++){
+    RandomRecord(&p[0], 1 + i % NumReadings);
+    *FormatSprintf(&p[0], a) = '\0';
+    *FormatFmt(&p[0], b) = '\0';
+    if(strcmp(a, b)){
+      printf("type %u differs:\n%s---\n%s", p[0].msgType, a, b);
+      return 1;
+    }
+  }
+
+  printf("%-8s%10s%10s%10s%10s\n", "type", "sprintf", "Fmt",
+         "sprintf", "Fmt");
+  printf("%-8s%20s%20s\n", "", "(ns/reply)", "(cycles/reply)");
+  for(t = 1; t <= NumReadings; t++){
+    RandomRecord(&p[t], t);
+    ts = TimeFormat(FormatSprintf, &p[t], 1);
+    tf = TimeFormat(FormatFmt, &p[t], 1);
+    printf("%-8s%10.1f%10.1f%10.0f%10.0f\n", TypeNames[t],
+           ts.ns, tf.ns, ts.cycles, tf.cycles);
+  }
+  // A mix of all types, as the payload task sees them
+  ts = TimeFormat(FormatSprintf, &p[1], NumReadings);
+  tf = TimeFormat(FormatFmt, &p[1], NumReadings);
+  printf("%-8s%10.1f%10.1f%10.0f%10.0f\n", "mix",
+         ts.ns, tf.ns, ts.cycles, tf.cycles);
+
+  return 0;
+}
+
+/*--------------- T i m e F o r m a t ---------------
+Return the time and cycles per reply of building BenchReplies replies,
+cycling through the n records at payloads.
+*/
+static Timing TimeFormat(FormatFn fn, Payload *payloads, CPU_INT32U n){
+  CPU_CHAR reply[ReplySize];
+  CPU_INT64U c0;
+  double start;
+  Timing t;
+  CPU_INT32U i;
+
+  start = BenchNow();
+  c0 = BenchCycles();
+  for(i = 0; i < BenchReplies; i++){
+    fn(&payloads[i % n], reply);
+    benchSink = reply[i % ReplySize / 4];
+  }
+  t.cycles = (double) (BenchCycles() - c0) / BenchReplies;
+  t.ns = (BenchNow() - start) * 1e9 / BenchReplies;
+
+  return t;
+}
+
+/*--------------- R a n d o m R e c o r d ---------------
+Fill a good payload record to this node of msgType with random data, as
+long as the type's fixed fields or a random ID
+*/
+static void RandomRecord(Payload *payload, CPU_INT08U msgType){
+  const MsgDef *m = MsgFind(msgType);
+  CPU_INT08U len = m->minData;
+  CPU_INT08U i;
+
+  if(msgType == MSG_SENSORID){
+    len = rand() % (IDLength + 1);
+    for(i = 0; i < len; i++)
+      payload->data[i] = 'A' + rand() % 26;
+  }else{
+    for(i = 0; i < len; i++)
+      payload->data[i] = rand();
+  }
+  payload->status = 0;
+  payload->payloadLen = MinBodyLength + len;
+  payload->rxTs = 0;
+  payload->dstAddr = MyAddress;
+  payload->srcAddr = rand();
+  payload->msgType = msgType;
+}
+
+/*--------------- F o r m a t F m t ---------------
+The payload task's TextReply, with any constant message it returns
+copied to reply as the reply queue would send it.
+*/
+static CPU_CHAR *FormatFmt(Payload *payload, CPU_CHAR reply[]){
+  const Msg_t *msg;
+  CPU_CHAR *end = TextReply(payload, reply, &msg);
+
+  if(msg != NULL){
+    memcpy(reply, msg->text, msg->len);
+    end = reply + msg->len;
+  }
+  return end;
+}
+
+/*--------------- F o r m a t S p r i n t f ---------------
+The reply to a reading as Payload.c built it with sprintf, from the wire
+bytes, and its end
+*/
+static CPU_CHAR *FormatSprintf(Payload *payload, CPU_CHAR reply[]){
+  const CPU_INT08U *d = payload->data;
+  CPU_INT32U w;
+  int n;
+
+  switch(payload->msgType){
+    case(MSG_TEMP):
+      n = sprintf(reply, "\nSOURCE NODE %d: TEMPERATURE MESSAGE\n  Temperature = %d\n",
+                  payload->srcAddr, (CPU_INT08S) d[0]);
+      break;
+    case(MSG_PRESSURE):
+      n = sprintf(reply, "\nSOURCE NODE %d: BAROMETRIC PRESSURE MESSAGE\n  Pressure = %d\n",
+                  payload->srcAddr, d[0] << 8 | d[1]);
+      break;
+    case(MSG_HUMIDITY):
+      n = sprintf(reply, "\nSOURCE NODE %d: HUMIDITY MESSAGE\n  Dew Point = %d Humidity = %u\n",
+                  payload->srcAddr, (CPU_INT08S) d[0], d[1]);
+      break;
+    case(MSG_WIND):
+      n = sprintf(reply, "\nSOURCE NODE %d: WIND MESSAGE\n  Speed = %d%d%d.%d Wind Direction = %d\n",
+                  payload->srcAddr,
+                  d[0] >> Nibble, d[0] & LowNibble,
+                  d[1] >> Nibble, d[1] & LowNibble,
+                  d[2] << 8 | d[3]);
+      break;
+    case(MSG_RADIATION):
+      n = sprintf(reply, "\nSOURCE NODE %d: SOLAR RADIATION MESSAGE\n  Solar Radiation Intensity = %u\n",
+                  payload->srcAddr, d[0] << 8 | d[1]);
+      break;
+    case(MSG_TIMESTAMP):
+      w = (CPU_INT32U) d[0] << 24 | d[1] << 16 | d[2] << 8 | d[3];
+      n = sprintf(reply, "\nSOURCE NODE %d: DATE/TIME STAMP MESSAGE\n  Time Stamp = %d/%d/%d %d:%d\n",
+                  payload->srcAddr,
+                  (int) (w >> MonthPosition & MonthMask),
+                  (int) (w >> DayPosition & DayMask),
+                  (int) (w >> YearPosition & YearMask),
+                  (int) (w >> HourPosition & HourMask),
+                  (int) (w >> MinutePosition & MinuteMask));
+      break;
+    case(MSG_PRECIPITATION):
+      n = sprintf(reply, "\nSOURCE NODE %d: PRECIPITATION MESSAGE\n  Precipitation Depth = %d%d.%d%d\n",
+                  payload->srcAddr,
+                  d[0] >> Nibble, d[0] & LowNibble,
+                  d[1] >> Nibble, d[1] & LowNibble);
+      break;
+    default:
+      n = sprintf(reply, "\nSOURCE NODE %d: SENSOR ID MESSAGE\n  Node ID = %.*s\n",
+                  payload->srcAddr, payload->payloadLen - MinBodyLength,
+                  (const char *) d);
+      break;
+  }
+
+  return reply + n;
+}
+
+/* Stand-ins for the reply queue and the parser. TextReply uses none of
+   them; the rest of Payload.c needs them to link. */
+ReplyBlk *ReplyQAlloc(ReplyPrio_t prio){
+  (void) prio;
+  return NULL;
+}
+
+void ReplyQPost(ReplyBlk *blk){
+  (void) blk;
+}
+
+void ReplyQFree(ReplyBlk *blk){
+  (void) blk;
+}
+
+void ReplyQSetPolicy(ReplyDrop_t policy){
+  (void) policy;
+}
+
+CPU_INT16U ReplyQDepth(void){
+  return 0;
+}
+
+CPU_INT32U ReplyQDropped(void){
+  return 0;
+}
+
+const ReplyClassStats *ReplyQStats(ReplyPrio_t prio){
+  static const ReplyClassStats none;
+
+  (void) prio;
+  return &none;
+}
+
+void ParserSetPromiscuous(CPU_BOOLEAN on){
+  (void) on;
+}
+
+CPU_INT32U ParserDropCount(CPU_INT08U dstAddr){
+  (void) dstAddr;
+  return 0;
+}
+
+const volatile ParserStats *ParserGetStats(void){
+  static ParserStats none;
+
+  return &none;
+}
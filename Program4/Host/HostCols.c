@@ -0,0 +1,210 @@
+/*--------------- H o s t C o l s . c ---------------
+
+by: Michael Nickelson
+
+PURPOSE
+Batch decoding of reading fields gathered into columns by the host tools.
+The date/time fields sit at the positions given in MsgDefs.h. The SSE2
+kernels take whole blocks and leave the rest to the scalar ones, which
+are also what other targets build.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+*/
+
+#include "includes.h"
+#include "HostCols.h"
+#include "MsgDefs.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define EpochYear 1970
+#define NumYears (YearMask + 2)   /* Every year field and the one after */
+#define NumMonths (MonthMask + 1)
+#define SecsPerDay 86400
+#define SecsPerHour 3600
+#define SecsPerMin 60
+#define LastHour 23
+#define LastMin 59
+#define NumBytes 256
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+/* Days from the epoch to 1 January of each year */
+static CPU_INT32S daysBeforeYear[NumYears];
+
+/* Days before each month and days in it, common years then leap years.
+   Month fields past 12 have no days. */
+static const CPU_INT16U DaysBeforeMonth[2][NumMonths] = {
+  {0, 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334},
+  {0, 0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335}};
+static const CPU_INT08U DaysInMonth[2][NumMonths] = {
+  {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31},
+  {0, 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31}};
+
+/* Value of each byte as two BCD digits */
+static CPU_INT08U bcdPair[NumBytes];
+
+/*----- l o c a l   f u n c t i o n    p r o t o t y p e s -----*/
+static CPU_BOOLEAN IsLeap(CPU_INT32S year);
+
+/*--------------- H o s t C o l s I n i t ---------------
+Build the tables. Call once before the other functions.
+*/
+void HostColsInit(void){
+  CPU_INT32S days = 0;
+  CPU_INT32S y;
+  int b;
+
+  for(y = 0; y < EpochYear; y++)
+    days -= IsLeap(y) ? 366 : 365;
+  for(y = 0; y < NumYears; y++){
+    daysBeforeYear[y] = days;
+    days += IsLeap(y) ? 366 : 365;
+  }
+  for(b = 0; b < NumBytes; b++)
+    bcdPair[b] = (b >> Nibble) * BcdBase + (b & LowNibble);
+}
+
+/*--------------- I s L e a p ---------------
+Gregorian leap year rule
+*/
+static CPU_BOOLEAN IsLeap(CPU_INT32S year){
+  return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+/*--------------- H o s t C o l s T i m e ---------------
+Split n packed date/time words, in host byte order, into columns
+*/
+void HostColsTime(const CPU_INT32U *packed, size_t n, const HostTimeCols *t){
+  size_t i = 0;
+
+#if defined(__SSE2__)
+  // Sixteen records a pass: the year in two stores of eight 16 bit lanes,
+  // the other fields narrowed to one store of sixteen bytes each
+#define FIELD(w, pos, mask) \
+  _mm_and_si128(_mm_srli_epi32(w, pos), _mm_set1_epi32(mask))
+#define BYTES(pos, mask) \
+  _mm_packus_epi16(_mm_packs_epi32(FIELD(w0, pos, mask), FIELD(w1, pos, mask)), \
+                   _mm_packs_epi32(FIELD(w2, pos, mask), FIELD(w3, pos, mask)))
+  __m128i w0, w1, w2, w3;
+
+  for(; i + 16 <= n; i += 16){
+    w0 = _mm_loadu_si128((const __m128i *) (packed + i));
+    w1 = _mm_loadu_si128((const __m128i *) (packed + i + 4));
+    w2 = _mm_loadu_si128((const __m128i *) (packed + i + 8));
+    w3 = _mm_loadu_si128((const __m128i *) (packed + i + 12));
+    _mm_storeu_si128((__m128i *) (t->year + i),
+                     _mm_packs_epi32(FIELD(w0, YearPosition, YearMask),
+                                     FIELD(w1, YearPosition, YearMask)));
+    _mm_storeu_si128((__m128i *) (t->year + i + 8),
+                     _mm_packs_epi32(FIELD(w2, YearPosition, YearMask),
+                                     FIELD(w3, YearPosition, YearMask)));
+    _mm_storeu_si128((__m128i *) (t->month + i),
+                     BYTES(MonthPosition, MonthMask));
+    _mm_storeu_si128((__m128i *) (t->day + i), BYTES(DayPosition, DayMask));
+    _mm_storeu_si128((__m128i *) (t->hour + i), BYTES(HourPosition, HourMask));
+    _mm_storeu_si128((__m128i *) (t->min + i),
+                     BYTES(MinutePosition, MinuteMask));
+  }
+#undef BYTES
+#undef FIELD
+#endif
+  if(i < n){
+    HostTimeCols rest = {t->year + i, t->month + i, t->day + i, t->hour + i,
+                         t->min + i};
+
+    HostColsTimeScalar(packed + i, n - i, &rest);
+  }
+}
+
+/*--------------- H o s t C o l s T i m e S c a l a r ---------------
+Split n packed date/time words one at a time
+*/
+void HostColsTimeScalar(const CPU_INT32U *packed, size_t n,
+                        const HostTimeCols *t){
+  CPU_INT32U w;
+  size_t i;
+
+  for(i = 0; i < n; i++){
+    w = packed[i];
+    t->year[i] = w >> YearPosition & YearMask;
+    t->month[i] = w >> MonthPosition & MonthMask;
+    t->day[i] = w >> DayPosition & DayMask;
+    t->hour[i] = w >> HourPosition & HourMask;
+    t->min[i] = w >> MinutePosition & MinuteMask;
+  }
+}
+
+/*--------------- H o s t C o l s E p o c h ---------------
+Convert n split time stamps to seconds since the epoch. Stamps that are
+not a date and time, like 2/30 or 25:00, become HostColsBadTime. Returns
+how many did.
+*/
+size_t HostColsEpoch(const HostTimeCols *t, size_t n, CPU_INT64S *secs){
+  size_t bad = 0;
+  CPU_INT16U y;
+  CPU_INT08U m;
+  CPU_INT08U leap;
+  size_t i;
+
+  for(i = 0; i < n; i++){
+    y = t->year[i];
+    m = t->month[i];
+    leap = daysBeforeYear[y + 1] - daysBeforeYear[y] - 365;
+    if(t->day[i] == 0 || t->day[i] > DaysInMonth[leap][m] ||
+       t->hour[i] > LastHour || t->min[i] > LastMin){
+      secs[i] = HostColsBadTime;
+      bad++;
+      continue;
+    }
+    secs[i] = (CPU_INT64S) (daysBeforeYear[y] + DaysBeforeMonth[leap][m] +
+                            t->day[i] - 1) * SecsPerDay +
+              t->hour[i] * SecsPerHour + t->min[i] * SecsPerMin;
+  }
+
+  return bad;
+}
+
+/*--------------- H o s t C o l s B c d ---------------
+Convert n 4 digit BCD readings, two bytes each and high digit first, to
+their values. Digits past 9 count at face value, as in MsgBcd.
+*/
+void HostColsBcd(const CPU_INT08U *bcd, size_t n, CPU_INT16U *values){
+  size_t i = 0;
+
+#if defined(__SSE2__)
+  // Eight readings a pass, one to a 16 bit lane with its high pair in the
+  // low byte. Each byte becomes its pair's value, then the lane the
+  // reading's.
+  const __m128i low = _mm_set1_epi16(0x0F0F);
+  const __m128i lowByte = _mm_set1_epi16(0xFF);
+  __m128i x;
+  __m128i pairs;
+
+  for(; i + 8 <= n; i += 8){
+    x = _mm_loadu_si128((const __m128i *) (bcd + 2*i));
+    pairs = _mm_add_epi16(
+              _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(x, Nibble), low),
+                              _mm_set1_epi16(BcdBase)),
+              _mm_and_si128(x, low));
+    x = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(pairs, lowByte),
+                                      _mm_set1_epi16(BcdBase * BcdBase)),
+                      _mm_srli_epi16(pairs, 8));
+    _mm_storeu_si128((__m128i *) (values + i), x);
+  }
+#endif
+  HostColsBcdScalar(bcd + 2*i, n - i, values + i);
+}
+
+/*--------------- H o s t C o l s B c d S c a l a r ---------------
+Convert n 4 digit BCD readings a byte pair at a time by table
+*/
+void HostColsBcdScalar(const CPU_INT08U *bcd, size_t n, CPU_INT16U *values){
+  size_t i;
+
+  for(i = 0; i < n; i++)
+    values[i] = bcdPair[bcd[2*i]] * BcdBase * BcdBase + bcdPair[bcd[2*i + 1]];
+}
@@ -0,0 +1,45 @@
+/*--------------- H o s t C o l s . h ---------------
+
+by: Michael Nickelson
+
+PURPOSE - Header file
+Batch decoding of reading fields gathered into columns by the host tools.
+Packed date/time words are split into one column per field, the columns
+are turned into seconds since 1970-01-01 00:00 UTC, and 4 digit BCD
+readings are turned into their values. With SSE2 the splits run 16
+records and the BCD 8 readings at a time; the epoch conversion uses
+tables of days before each year and month.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+*/
+
+#ifndef HOSTCOLS_H
+#define HOSTCOLS_H
+
+#include "includes.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+/* Epoch seconds of a time stamp that is not a date */
+#define HostColsBadTime INT64_MIN
+
+/*----- t y p e d e f s   u s e d   b y   t h e   c o l u m n s -----*/
+/* Date/time fields, one array per field, all of the same length */
+typedef struct{
+  CPU_INT16U *year;
+  CPU_INT08U *month;
+  CPU_INT08U *day;
+  CPU_INT08U *hour;
+  CPU_INT08U *min;
+} HostTimeCols;
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void HostColsInit(void);
+void HostColsTime(const CPU_INT32U *packed, size_t n, const HostTimeCols *t);
+void HostColsTimeScalar(const CPU_INT32U *packed, size_t n,
+                        const HostTimeCols *t);
+size_t HostColsEpoch(const HostTimeCols *t, size_t n, CPU_INT64S *secs);
+void HostColsBcd(const CPU_INT08U *bcd, size_t n, CPU_INT16U *values);
+void HostColsBcdScalar(const CPU_INT08U *bcd, size_t n, CPU_INT16U *values);
+
+#endif
@@ -0,0 +1,128 @@
+/*--------------- H o s t O S . c ---------------
+
+by: Michael Nickelson
+
+PURPOSE
+Host stand-ins for the uC/CPU and uC/OS-III calls declared in the host
+includes.h, enough to run the payload task's reply code in one thread.
+Tasks are not started and semaphores never wait: a pend takes a count if
+there is one and times out at once if not. The CPU_TS timer and the tick
+count run from the host's monotonic clock at the board's rates, so time
+stamps convert as they do on the target.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+*/
+
+#include "includes.h"
+#include <time.h>
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define TsTmrFreq 72000000UL    /* CPU_TS timer of the 72 MHz board */
+#define NsPerSec 1000000000ULL
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+const OS_TICK OSCfg_TickRate_Hz = 1000;
+
+/*----- l o c a l   f u n c t i o n    p r o t o t y p e s -----*/
+static CPU_INT64U NowNs(void);
+
+/*--------------- C P U _ T S _ G e t 3 2 ---------------
+Return the CPU_TS timer, counting at TsTmrFreq
+*/
+CPU_TS CPU_TS_Get32(void){
+  return (CPU_TS) (NowNs() * (TsTmrFreq / 1000000) / 1000);
+}
+
+/*--------------- C P U _ T S _ T m r F r e q G e t ---------------
+Return the rate of the CPU_TS timer
+*/
+CPU_TS_TMR_FREQ CPU_TS_TmrFreqGet(CPU_ERR *p_err){
+  *p_err = 0;
+  return TsTmrFreq;
+}
+
+/*--------------- O S S e m C r e a t e ---------------
+Set the semaphore's count
+*/
+void OSSemCreate(OS_SEM *p_sem, CPU_CHAR *p_name, OS_SEM_CTR cnt,
+                 OS_ERR *p_err){
+  (void) p_name;
+  p_sem->ctr = cnt;
+  *p_err = OS_ERR_NONE;
+}
+
+/*--------------- O S S e m P e n d ---------------
+Take a count, or time out at once if there is none, as no other task can
+post one
+*/
+OS_SEM_CTR OSSemPend(OS_SEM *p_sem, OS_TICK timeout, OS_OPT opt,
+                     CPU_TS *p_ts, OS_ERR *p_err){
+  (void) timeout;
+  (void) opt;
+  if(p_ts != NULL)
+    *p_ts = CPU_TS_Get32();
+  if(p_sem->ctr == 0){
+    *p_err = OS_ERR_TIMEOUT;
+    return 0;
+  }
+  *p_err = OS_ERR_NONE;
+
+  return --p_sem->ctr;
+}
+
+/*--------------- O S S e m P o s t ---------------
+Add a count
+*/
+OS_SEM_CTR OSSemPost(OS_SEM *p_sem, OS_OPT opt, OS_ERR *p_err){
+  (void) opt;
+  *p_err = OS_ERR_NONE;
+
+  return ++p_sem->ctr;
+}
+
+/*--------------- O S T a s k C r e a t e ---------------
+Note the task without starting it. The host tools call the code they
+need directly.
+*/
+void OSTaskCreate(OS_TCB *p_tcb, CPU_CHAR *p_name, OS_TASK_PTR p_task,
+                  void *p_arg, OS_PRIO prio, CPU_STK *p_stk_base,
+                  CPU_STK_SIZE stk_limit, CPU_STK_SIZE stk_size,
+                  OS_MSG_QTY q_size, OS_TICK time_quanta, void *p_ext,
+                  OS_OPT opt, OS_ERR *p_err){
+  (void) p_name; (void) p_arg; (void) prio; (void) p_stk_base;
+  (void) stk_limit; (void) stk_size; (void) q_size; (void) time_quanta;
+  (void) p_ext; (void) opt;
+  p_tcb->task = p_task;
+  *p_err = OS_ERR_NONE;
+}
+
+/*--------------- O S T i m e G e t ---------------
+Return the ticks since the host clock's start
+*/
+OS_TICK OSTimeGet(OS_ERR *p_err){
+  *p_err = OS_ERR_NONE;
+  return (OS_TICK) (NowNs() / (NsPerSec / OSCfg_TickRate_Hz));
+}
+
+/*--------------- O S T i m e D l y ---------------
+Sleep for dly ticks
+*/
+void OSTimeDly(OS_TICK dly, OS_OPT opt, OS_ERR *p_err){
+  CPU_INT64U ns = (CPU_INT64U) dly * (NsPerSec / OSCfg_TickRate_Hz);
+  struct timespec ts = {ns / NsPerSec, ns % NsPerSec};
+
+  (void) opt;
+  nanosleep(&ts, NULL);
+  *p_err = OS_ERR_NONE;
+}
+
+/*--------------- N o w N s ---------------
+Monotonic time in nanoseconds
+*/
+static CPU_INT64U NowNs(void){
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (CPU_INT64U) ts.tv_sec * NsPerSec + ts.tv_nsec;
+}
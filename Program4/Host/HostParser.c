@@ -0,0 +1,157 @@
+/*--------------- H o s t P a r s e r . c ---------------
+
+by: Michael Nickelson
+
+PURPOSE
+Host side version of the PktParser state machine used for decoding
+captures offline. The states and error reports follow PktParser.c so that
+a capture decodes the same way on the host as it would on the target.
+Frames that lie entirely inside a span are handed out in place; only a
+frame that straddles two spans is collected into the parser's own buffer.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Fold frame bodies into the checksum with FrameXor
+10-19-2026 mn -  CRC-16 framing selectable per stream
+*/
+
+#include "HostParser.h"
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+static const CPU_INT08U Preamble[HeaderLength-1] = {Preamble1, Preamble2,
+                                                    Preamble3};
+
+/*----- l o c a l   m a c r o s -----*/
+#define ChkStart(hp) ((hp)->crc ? CrcInit : 0)
+
+/*----- l o c a l   f u n c t i o n    p r o t o t y p e s -----*/
+static void ErrorTransition(HostParser *hp, CPU_INT64U off, Error_t e);
+
+/*--------------- H o s t P a r s e r I n i t ---------------
+Reset the parser. offset is the stream offset of the first byte that will
+be handed to HostParseSpan. crc selects CRC-16 framing for the stream.
+*/
+void HostParserInit(HostParser *hp, CPU_INT64U offset, CPU_BOOLEAN crc,
+                    HostFrameFn onFrame, HostErrFn onErr, void *ctx){
+  hp->parseState = HP_P;
+  hp->crc = crc;
+  hp->checkSum = ChkStart(hp);
+  hp->pb = 0;
+  hp->frameLen = 0;
+  hp->have = 0;
+  hp->offset = offset;
+  hp->frameOff = offset;
+  hp->onFrame = onFrame;
+  hp->onErr = onErr;
+  hp->ctx = ctx;
+}
+
+/*--------------- H o s t P a r s e S p a n ---------------
+Run the state machine over the next n bytes of the stream.
+*/
+void HostParseSpan(HostParser *hp, const CPU_INT08U *span, size_t n){
+  const CPU_INT64U spanOff = hp->offset;
+  const CPU_INT16U shortest = HeaderLength + MinBodyLength +
+                              (hp->crc ? CrcLength : ChkLength);
+  size_t i = 0;
+  size_t run;
+  CPU_INT08U c;
+
+  while(i < n){
+    if(hp->parseState == HP_R){
+      // Take as much of the frame body as this span holds in one run
+      run = hp->frameLen - hp->have;
+      if(run > n - i)
+        run = n - i;
+      if(hp->crc)
+        hp->checkSum = FrameCrc16Slice8(hp->checkSum, &span[i], run);
+      else
+        hp->checkSum ^= FrameXor(&span[i], run);
+      // A frame that began in an earlier span is collected as it goes
+      if(hp->frameOff < spanOff)
+        memcpy(&hp->frame[hp->have], &span[i], run);
+      hp->have += run;
+      i += run;
+
+      if(hp->have >= hp->frameLen){
+        if(hp->checkSum){
+          ErrorTransition(hp, spanOff + i - 1, ERR_CHECKSUM);
+        }else{
+          hp->parseState = HP_P;
+          hp->checkSum = ChkStart(hp);
+          if(hp->onFrame){
+            if(hp->frameOff >= spanOff)
+              hp->onFrame(hp->ctx, hp->frameOff,
+                          &span[hp->frameOff - spanOff], hp->frameLen);
+            else
+              hp->onFrame(hp->ctx, hp->frameOff, hp->frame, hp->frameLen);
+          }
+        }
+      }
+      continue;
+    }
+
+    c = span[i];
+    // Maintain running checksum as bytes are received
+    hp->checkSum = hp->crc ? Crc16Byte(hp->checkSum, c) : hp->checkSum ^ c;
+
+    switch(hp->parseState){
+      case HP_P:  // Look for a preamble
+        if(hp->pb == 0)
+          hp->frameOff = spanOff + i;
+        if(c != Preamble[hp->pb++]){
+          // Use preamble index that was being compared as the error code
+          ErrorTransition(hp, spanOff + i, (Error_t) -(hp->pb));
+          hp->pb = 0;
+        }else if(hp->pb >= HeaderLength-1){
+          hp->pb = 0;
+          hp->parseState = HP_L;
+        }
+        break;
+      case HP_L:  // Read in packet length
+        if(c < shortest){
+          ErrorTransition(hp, spanOff + i, ERR_LEN);
+        }else{
+          hp->frameLen = c;
+          hp->have = HeaderLength;
+          memcpy(hp->frame, Preamble, HeaderLength-1);
+          hp->frame[HeaderLength-1] = c;
+          hp->parseState = HP_R;
+        }
+        break;
+      case HP_ER: // Do not report another error until a full preamble is found
+      default:
+        if(c == Preamble[hp->pb]){
+          if(hp->pb == 0)
+            hp->frameOff = spanOff + i;
+          hp->pb++;
+        }else{
+          hp->pb = 0;
+          hp->checkSum = ChkStart(hp);
+        }
+        if(hp->pb >= HeaderLength-1){
+          hp->pb = 0;
+          hp->parseState = HP_L;
+        }
+        break;
+    }
+    i++;
+  }
+
+  // Keep the part of a frame seen in this span before the span goes away
+  if(hp->parseState == HP_R && hp->frameOff >= spanOff)
+    memcpy(&hp->frame[HeaderLength], &span[hp->frameOff - spanOff + HeaderLength],
+           hp->have - HeaderLength);
+
+  hp->offset = spanOff + n;
+}
+
+/*--------------- E r r o r T r a n s i t i o n ---------------
+Report an error and hunt for the next full preamble.
+*/
+static void ErrorTransition(HostParser *hp, CPU_INT64U off, Error_t e){
+  if(hp->onErr)
+    hp->onErr(hp->ctx, off, e);
+  hp->checkSum = ChkStart(hp);
+  hp->parseState = HP_ER;
+}
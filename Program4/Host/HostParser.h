@@ -0,0 +1,56 @@
+/*--------------- H o s t P a r s e r . h ---------------
+
+by: Michael Nickelson
+
+PURPOSE - Header file
+Host side version of the PktParser state machine used for decoding
+captures offline. Input is handed over in spans of any size and the parser
+state carries from one span to the next, so frames may straddle spans.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Frame layout now comes from FrameChk.h
+10-19-2026 mn -  CRC-16 framing selectable per stream
+*/
+
+#ifndef HOSTPARSER_H
+#define HOSTPARSER_H
+
+#include "includes.h"
+#include "Error.h"
+#include "FrameChk.h"
+
+/*----- t y p e d e f s   u s e d   b y   t h e   h o s t   p a r s e r -----*/
+/* Parser state data type */
+typedef enum { HP_P, HP_L, HP_R, HP_ER } HostParserState;
+
+/* Called for each good frame. frame points at the first preamble byte and
+   len is the frame length byte. off is the stream offset of the frame. */
+typedef void (*HostFrameFn)(void *ctx, CPU_INT64U off,
+                            const CPU_INT08U *frame, CPU_INT16U len);
+
+/* Called for each error the target parser would report */
+typedef void (*HostErrFn)(void *ctx, CPU_INT64U off, Error_t e);
+
+/* Parser state carried between spans */
+typedef struct{
+  HostParserState parseState;
+  CPU_BOOLEAN crc;            // Frames carry a CRC-16 rather than a checksum
+  CPU_INT16U checkSum;        // Running checksum or CRC
+  CPU_INT08U pb;              // Preamble bytes matched so far
+  CPU_INT16U frameLen;        // Length byte of the frame in progress
+  CPU_INT16U have;            // Bytes of the frame in progress seen so far
+  CPU_INT64U offset;          // Stream offset of the next byte
+  CPU_INT64U frameOff;        // Stream offset of the frame in progress
+  HostFrameFn onFrame;
+  HostErrFn onErr;
+  void *ctx;
+  CPU_INT08U frame[MaxFrameLen];  // Holds a frame that straddles spans
+} HostParser;
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+void HostParserInit(HostParser *hp, CPU_INT64U offset, CPU_BOOLEAN crc,
+                    HostFrameFn onFrame, HostErrFn onErr, void *ctx);
+void HostParseSpan(HostParser *hp, const CPU_INT08U *span, size_t n);
+
+#endif
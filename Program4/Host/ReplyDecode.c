@@ -0,0 +1,268 @@
+/*--------------- R e p l y D e c o d e . c ---------------
+
+by: Michael Nickelson
+
+PURPOSE
+Decoder for the binary replies of the payload task, laid out in
+BinReply.h. The reply stream is framed like the sensor packets, so it is
+parsed with the HostParser state machine. Each reply is printed the way
+the text reply would have read.
+With -s a summary follows: for each message type, the bytes per reading
+on the line in binary and in text, and how many readings a second the
+serial line can carry in each format.
+With -c the replies are taken to be framed with CRC-16 rather than the
+XOR checksum byte.
+
+Build:  cc -O2 -I. -I../App -o ReplyDecode ReplyDecode.c HostParser.c \
+                          ../App/FrameChk.c ../App/Error.c
+Usage:  ReplyDecode [-c] [-q] [-s] [replies]
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Line rate from SerLine.h
+*/
+
+#include "includes.h"
+#include <unistd.h>
+#include "BinReply.h"
+#include "HostParser.h"
+#include "SerLine.h"
+
+/*----- c o n s t a n t    d e f i n i t i o n s -----*/
+#define DstOffset 4       /* Offsets of body fields within a frame */
+#define SrcOffset 5
+#define TypeOffset 6
+#define NumTypes (BinTypeMask + 1)
+#define BfrSize 4096
+#define TextSize 160
+
+/*----- t y p e d e f s   u s e d   b y   t h e   d e c o d e r -----*/
+typedef struct{
+  CPU_BOOLEAN quiet;
+  CPU_INT08U trailer;       // Checksum or CRC bytes ending each frame
+  CPU_INT64U frames;
+  CPU_INT64U bad;
+  CPU_INT64U count[NumTypes];
+  CPU_INT64U binBytes[NumTypes];
+  CPU_INT64U textBytes[NumTypes];
+} Tally;
+
+/*----- G l o b a l   V a r i a b l e s -----*/
+static const char *TypeNames[NumTypes] = {
+  [1] = "temperature", [2] = "pressure", [3] = "humidity", [4] = "wind",
+  [5] = "radiation", [6] = "time stamp", [7] = "precipitation",
+  [8] = "sensor ID", [BinText] = "text", [BinError] = "error/info"};
+
+static const char *ErrNames[NumErrors] = {"", "preamble 1", "preamble 2",
+                                        "preamble 3", "checksum", "length",
+                                        "message type"};
+
+/*----- l o c a l   f u n c t i o n    p r o t o t y p e s -----*/
+static void OnFrame(void *ctx, CPU_INT64U off, const CPU_INT08U *frame,
+                    CPU_INT16U len);
+static void OnErr(void *ctx, CPU_INT64U off, Error_t e);
+static int Decode(const CPU_INT08U *frame, CPU_INT16U len,
+                  CPU_INT08U trailer, char text[]);
+static CPU_INT16U Get16(const CPU_INT08U *p);
+static CPU_INT32U Get32(const CPU_INT08U *p);
+static void Report(const Tally *t);
+
+/*--------------- m a i n ( ) -----------------*/
+int main(int argc, char *argv[]){
+  static HostParser hp;
+  static Tally tally;
+  static CPU_INT08U bfr[BfrSize];
+  CPU_BOOLEAN crc = FALSE;
+  CPU_BOOLEAN summary = FALSE;
+  FILE *f = stdin;
+  size_t n;
+  int opt;
+
+  while((opt = getopt(argc, argv, "cqs")) != -1){
+    switch(opt){
+      case 'c':
+        crc = TRUE;
+        break;
+      case 'q':
+        tally.quiet = TRUE;
+        break;
+      case 's':
+        summary = TRUE;
+        break;
+      default:
+        fprintf(stderr, "Usage: %s [-c] [-q] [-s] [replies]\n", argv[0]);
+        return 2;
+    }
+  }
+  if(optind < argc && (f = fopen(argv[optind], "rb")) == NULL){
+    perror(argv[optind]);
+    return 1;
+  }
+
+  FrameCrc16Init();
+  tally.trailer = crc ? CrcLength : ChkLength;
+  HostParserInit(&hp, 0, crc, OnFrame, OnErr, &tally);
+  while((n = fread(bfr, 1, sizeof(bfr), f)) > 0)
+    HostParseSpan(&hp, bfr, n);
+  if(f != stdin)
+    fclose(f);
+
+  if(summary)
+    Report(&tally);
+  return tally.bad != 0;
+}
+
+/*--------------- O n F r a m e ---------------
+Print a reply and count it
+*/
+static void OnFrame(void *ctx, CPU_INT64U off, const CPU_INT08U *frame,
+                    CPU_INT16U len){
+  Tally *t = ctx;
+  CPU_INT08U type = frame[TypeOffset] & BinTypeMask;
+  char text[TextSize];
+  int n;
+
+  if(frame[DstOffset] != BinHost ||
+     (n = Decode(frame, len, t->trailer, text)) < 0){
+    fprintf(stderr, "%llu: not a reply\n", (unsigned long long) off);
+    t->bad++;
+    return;
+  }
+  t->frames++;
+  t->count[type]++;
+  t->binBytes[type] += len;
+  t->textBytes[type] += n;
+  if(!t->quiet)
+    fputs(text, stdout);
+}
+
+/*--------------- O n E r r ---------------
+Count a damaged reply
+*/
+static void OnErr(void *ctx, CPU_INT64U off, Error_t e){
+  Tally *t = ctx;
+
+  fprintf(stderr, "%llu: %s error\n", (unsigned long long) off,
+          ErrNames[-e]);
+  t->bad++;
+}
+
+/*--------------- D e c o d e ---------------
+Write the text reply a good frame stands for into text and return its
+length, or -1 if the frame is not a reply.
+*/
+static int Decode(const CPU_INT08U *frame, CPU_INT16U len,
+                  CPU_INT08U trailer, char text[]){
+  CPU_INT08U src = frame[SrcOffset];
+  CPU_INT08U type = frame[TypeOffset] & BinTypeMask;
+  const CPU_INT08U *d = &frame[TypeOffset + 1];
+  const Msg_t *msg;
+  CPU_INT32U us = 0;
+  int dataLen;
+  int n = 0;
+
+  if(frame[TypeOffset] & BinStamped){
+    us = Get32(d);
+    d += BinStampLength;
+  }
+  dataLen = (int) (frame + len - d) - trailer;
+  if(dataLen < 0)
+    return -1;
+
+  switch(type){
+    case 1:
+      if(dataLen != BinTempLength) return -1;
+      n = sprintf(text, "\nSOURCE NODE %u: TEMPERATURE MESSAGE\n"
+                  "  Temperature = %d\n", src, (CPU_INT08S) d[0]);
+      break;
+    case 2:
+      if(dataLen != BinPresLength) return -1;
+      n = sprintf(text, "\nSOURCE NODE %u: BAROMETRIC PRESSURE MESSAGE\n"
+                  "  Pressure = %u\n", src, Get16(d));
+      break;
+    case 3:
+      if(dataLen != BinHumLength) return -1;
+      n = sprintf(text, "\nSOURCE NODE %u: HUMIDITY MESSAGE\n"
+                  "  Dew Point = %d Humidity = %u\n", src,
+                  (CPU_INT08S) d[0], d[1]);
+      break;
+    case 4:
+      if(dataLen != BinWindLength) return -1;
+      n = sprintf(text, "\nSOURCE NODE %u: WIND MESSAGE\n"
+                  "  Speed = %03u.%u Wind Direction = %u\n", src,
+                  Get16(d) / 10, Get16(d) % 10, Get16(d + 2));
+      break;
+    case 5:
+      if(dataLen != BinRadLength) return -1;
+      n = sprintf(text, "\nSOURCE NODE %u: SOLAR RADIATION MESSAGE\n"
+                  "  Solar Radiation Intensity = %u\n", src, Get16(d));
+      break;
+    case 6:
+      if(dataLen != BinTimeLength) return -1;
+      n = sprintf(text, "\nSOURCE NODE %u: DATE/TIME STAMP MESSAGE\n"
+                  "  Time Stamp = %u/%u/%u %u:%u\n", src,
+                  d[2], d[3], Get16(d), d[4], d[5]);
+      break;
+    case 7:
+      if(dataLen != BinPrecipLength) return -1;
+      n = sprintf(text, "\nSOURCE NODE %u: PRECIPITATION MESSAGE\n"
+                  "  Precipitation Depth = %02u.%02u\n", src,
+                  Get16(d) / 100, Get16(d) % 100);
+      break;
+    case 8:
+      n = sprintf(text, "\nSOURCE NODE %u: SENSOR ID MESSAGE\n"
+                  "  Node ID = %.*s\n", src, dataLen, (const char *) d);
+      break;
+    case BinText:
+      n = sprintf(text, "%.*s", dataLen, (const char *) d);
+      break;
+    case BinError:
+      if(dataLen != BinErrorLength) return -1;
+      // The payload task sends the same table messages in text
+      if((CPU_INT08S) d[0] < 0)
+        msg = ErrMsg((Error_t) (CPU_INT08S) d[0]);
+      else
+        msg = AssertMsg((Assert_t) d[0]);
+      n = sprintf(text, "%s", msg->text);
+      break;
+    default:
+      return -1;
+  }
+  if(frame[TypeOffset] & BinStamped)
+    n += sprintf(text + n, "  Received at %lu us\n", (unsigned long) us);
+
+  return n;
+}
+
+/* Little endian fields */
+static CPU_INT16U Get16(const CPU_INT08U *p){
+  return p[0] | p[1] << 8;
+}
+
+static CPU_INT32U Get32(const CPU_INT08U *p){
+  return Get16(p) | (CPU_INT32U) Get16(p + 2) << 16;
+}
+
+/*--------------- R e p o r t ---------------
+Print bytes per reading and the readings a second the line can carry in
+each format
+*/
+static void Report(const Tally *t){
+  double bin;
+  double text;
+  int i;
+
+  printf("%llu replies, %llu bad\n", (unsigned long long) t->frames,
+         (unsigned long long) t->bad);
+  printf("%-14s%8s%8s%8s%10s%10s\n", "type", "count", "binary", "text",
+         "bin/s", "text/s");
+  for(i = 0; i < NumTypes; i++){
+    if(t->count[i] == 0)
+      continue;
+    bin = (double) t->binBytes[i] / t->count[i];
+    text = (double) t->textBytes[i] / t->count[i];
+    printf("%-14s%8llu%8.1f%8.1f%10.1f%10.1f\n",
+           TypeNames[i] ? TypeNames[i] : "?", (unsigned long long) t->count[i],
+           bin, text, SerBytesPerSec / bin, SerBytesPerSec / text);
+  }
+}
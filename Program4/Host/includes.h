@@ -0,0 +1,97 @@
+/*--------------- i n c l u d e s . h ---------------
+
+by: Michael Nickelson
+
+PURPOSE
+Host build stand-in for the Micrium includes.h.
+Supplies the CPU_ data types so the portable App modules and the host tools
+can be compiled with a native compiler, and the few uC/CPU and uC/OS-III
+types and calls the payload task uses, so its reply code can be built on
+the host too. HostOS.c implements the calls.
+
+CHANGES
+10-19-2026 mn -  Initial submission
+10-19-2026 mn -  Host builds include the slice-by-8 CRC
+10-19-2026 mn -  uC/CPU time stamp and uC/OS-III stand-ins
+*/
+
+#ifndef INCLUDES_H
+#define INCLUDES_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+/*----- t y p e d e f s   m a t c h i n g   u C / C P U -----*/
+typedef void            CPU_VOID;
+typedef char            CPU_CHAR;
+typedef uint8_t         CPU_BOOLEAN;
+typedef uint8_t         CPU_INT08U;
+typedef int8_t          CPU_INT08S;
+typedef uint16_t        CPU_INT16U;
+typedef int16_t         CPU_INT16S;
+typedef uint32_t        CPU_INT32U;
+typedef int32_t         CPU_INT32S;
+typedef uint64_t        CPU_INT64U;
+typedef int64_t         CPU_INT64S;
+
+/*----- t y p e d e f s   m a t c h i n g   u C / C P U   t i m e -----*/
+typedef uint32_t        CPU_TS;
+typedef uint32_t        CPU_TS_TMR_FREQ;
+typedef uint32_t        CPU_SR;
+typedef uint32_t        CPU_STK;
+typedef uint32_t        CPU_STK_SIZE;
+typedef int             CPU_ERR;
+
+/* Interrupts are not masked on the host; the stand-ins are single threaded */
+#define CPU_SR_ALLOC()          CPU_SR cpu_sr = 0
+#define CPU_CRITICAL_ENTER()    (void) cpu_sr
+#define CPU_CRITICAL_EXIT()     (void) cpu_sr
+
+/*----- t y p e d e f s   m a t c h i n g   u C / O S - I I I -----*/
+typedef uint32_t        OS_TICK;
+typedef uint16_t        OS_OPT;
+typedef uint32_t        OS_SEM_CTR;
+typedef uint8_t         OS_PRIO;
+typedef uint16_t        OS_MSG_QTY;
+typedef int             OS_ERR;
+typedef void            (*OS_TASK_PTR)(void *p_arg);
+typedef struct {OS_SEM_CTR ctr;} OS_SEM;
+typedef struct {OS_TASK_PTR task;} OS_TCB;
+
+#define OS_ERR_NONE             0
+#define OS_ERR_TIMEOUT          1
+#define OS_OPT_PEND_BLOCKING    0
+#define OS_OPT_POST_1           0
+#define OS_OPT_TIME_DLY         0
+
+extern const OS_TICK OSCfg_TickRate_Hz;
+
+/*----- f u n c t i o n    p r o t o t y p e s -----*/
+CPU_TS CPU_TS_Get32(void);
+CPU_TS_TMR_FREQ CPU_TS_TmrFreqGet(CPU_ERR *p_err);
+void OSSemCreate(OS_SEM *p_sem, CPU_CHAR *p_name, OS_SEM_CTR cnt,
+                 OS_ERR *p_err);
+OS_SEM_CTR OSSemPend(OS_SEM *p_sem, OS_TICK timeout, OS_OPT opt,
+                     CPU_TS *p_ts, OS_ERR *p_err);
+OS_SEM_CTR OSSemPost(OS_SEM *p_sem, OS_OPT opt, OS_ERR *p_err);
+void OSTaskCreate(OS_TCB *p_tcb, CPU_CHAR *p_name, OS_TASK_PTR p_task,
+                  void *p_arg, OS_PRIO prio, CPU_STK *p_stk_base,
+                  CPU_STK_SIZE stk_limit, CPU_STK_SIZE stk_size,
+                  OS_MSG_QTY q_size, OS_TICK time_quanta, void *p_ext,
+                  OS_OPT opt, OS_ERR *p_err);
+OS_TICK OSTimeGet(OS_ERR *p_err);
+void OSTimeDly(OS_TICK dly, OS_OPT opt, OS_ERR *p_err);
+
+/* Host builds have room for the slice-by-8 CRC tables */
+#define CrcSlice8 1
+
+#ifndef TRUE
+#define TRUE 1
+#endif
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+#endif